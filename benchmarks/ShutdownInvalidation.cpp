@@ -0,0 +1,107 @@
+// Copyright (c) embedded ocean GmbH
+//
+// Measures how long it takes to set all data points of an I/O component to "No Data" at shutdown. This does the same
+// thing as TemplateIoComponent::invalidatePoints(), for 10k, 100k and 1M data points, once with each data point on its
+// own, and once with the data points in groups of the maximum size.
+
+#include "ReadState.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace
+{
+
+using namespace xentara::plugins::templateDriver;
+
+/// @brief Sets up a number of data points with valid data, and times how long it takes to invalidate all of them
+/// @param pointCount The number of data points
+/// @param grouped Whether to put the data points into groups
+/// @return The time the invalidation took
+auto measure(std::size_t pointCount, bool grouped) -> std::chrono::nanoseconds
+{
+	using Group = ReadState<double>::Group;
+
+	const auto parent = std::make_shared<int>();
+
+	// Create the data points, and the groups if requested
+	std::vector<ReadState<double>> points(pointCount);
+	std::vector<std::unique_ptr<Group>> groups;
+	if (grouped)
+	{
+		groups.resize((pointCount + Group::kMaxSize - 1) / Group::kMaxSize);
+		for (std::size_t index = 0; index < pointCount; ++index)
+		{
+			auto &group = groups[index / Group::kMaxSize];
+			if (!group)
+			{
+				group = std::make_unique<Group>();
+			}
+			group->add(points[index]);
+		}
+	}
+	for (auto &point : points)
+	{
+		point.realize(parent);
+	}
+	for (auto &group : groups)
+	{
+		group->realize();
+	}
+
+	// Give all the data points a value, so that each of them actually needs a commit
+	const auto readTime = std::chrono::system_clock::now();
+	if (grouped)
+	{
+		const std::vector<double> values(Group::kMaxSize, 1.0);
+		for (auto &group : groups)
+		{
+			group->update(readTime, std::span(values).first(group->size()));
+		}
+	}
+	else
+	{
+		for (auto &point : points)
+		{
+			point.update(readTime, 1.0);
+		}
+	}
+
+	// Invalidate all the data points in one pass
+	const auto invalidationTime = readTime + std::chrono::seconds(1);
+	const auto start = std::chrono::steady_clock::now();
+	for (auto &group : groups)
+	{
+		group->update(invalidationTime, CustomError::NoData);
+	}
+	for (auto &point : points)
+	{
+		if (!point.group())
+		{
+			point.invalidate(invalidationTime);
+		}
+	}
+	return std::chrono::steady_clock::now() - start;
+}
+
+} // namespace
+
+auto main() -> int
+{
+	for (const std::size_t pointCount : { 10'000, 100'000, 1'000'000 })
+	{
+		for (const bool grouped : { false, true })
+		{
+			const auto elapsed = measure(pointCount, grouped);
+			std::cout << pointCount << " data points" << (grouped ? " in groups" : "") << ": "
+				<< std::chrono::duration<double, std::milli>(elapsed).count() << " ms ("
+				<< double(elapsed.count()) / double(pointCount) << " ns per data point)\n";
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+// Copyright (c) embedded ocean GmbH
+//
+// Measures the throughput of SingleValueQueue under contention. Several writer threads enqueue values, like concurrent
+// write handles of an output, while a single reader dequeues them, like the "write" task. The writers either enqueue as
+// fast as they can, or pause for a microsecond between values. This compares the version using a single lock-free atomic
+// for values of type double with the version using a sequence lock, for values of type double as well as for 16 byte
+// timestamped values.
+
+#include "SingleValueQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace xentara::plugins::templateDriver;
+
+/// @brief A value with a time stamp, which does not fit into a lock-free atomic
+struct TimestampedValue final
+{
+	/// @brief The value
+	double _value { 0.0 };
+	/// @brief The time stamp, in nanoseconds since the epoch
+	std::int64_t _timeStamp { 0 };
+};
+
+/// @brief How long each measurement runs
+constexpr auto kDuration = std::chrono::milliseconds(500);
+
+/// @brief Runs writers and a reader on a queue for a while, and prints the number of operations per second
+/// @tparam Queue The queue type
+/// @param name The name of the queue to print
+/// @param writerCount The number of writer threads
+/// @param pause The time each writer waits between values
+/// @param makeValue A function that creates the value to enqueue from a counter
+template <typename Queue, typename MakeValue>
+auto measure(std::string_view name, std::size_t writerCount, std::chrono::nanoseconds pause, MakeValue makeValue) -> void
+{
+	Queue queue;
+	std::atomic<bool> stop { false };
+	std::atomic<std::uint64_t> enqueued { 0 };
+	std::uint64_t dequeued { 0 };
+
+	// Start the writers
+	std::vector<std::jthread> writers;
+	for (std::size_t index = 0; index < writerCount; ++index)
+	{
+		writers.emplace_back([&]() {
+			std::uint64_t count { 0 };
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				queue.enqueue(makeValue(count));
+				++count;
+
+				// Busy wait, so that the writer is not descheduled
+				const auto next = std::chrono::steady_clock::now() + pause;
+				while (pause.count() != 0 && std::chrono::steady_clock::now() < next)
+				{
+				}
+			}
+			enqueued.fetch_add(count, std::memory_order_relaxed);
+		});
+	}
+
+	// Dequeue on this thread until the time is up
+	const auto end = std::chrono::steady_clock::now() + kDuration;
+	while (std::chrono::steady_clock::now() < end)
+	{
+		if (queue.dequeue())
+		{
+			++dequeued;
+		}
+	}
+	stop = true;
+	writers.clear();
+
+	const auto seconds = std::chrono::duration<double>(kDuration).count();
+	std::cout << name << ", " << writerCount << " writers, " << pause.count() << " ns pause: "
+		<< double(enqueued) / seconds / 1e6 << " M enqueues/s, " << double(dequeued) / seconds / 1e6 << " M values dequeued/s\n";
+}
+
+} // namespace
+
+auto main() -> int
+{
+	for (const auto pause : { std::chrono::nanoseconds(0), std::chrono::nanoseconds(std::chrono::microseconds(1)) })
+	{
+		for (const std::size_t writerCount : { 1, 2, 4 })
+		{
+			measure<SingleValueQueue<double>>("atomic, double", writerCount, pause,
+				[](std::uint64_t count) { return double(count); });
+			measure<SingleValueQueue<double, false>>("sequence lock, double", writerCount, pause,
+				[](std::uint64_t count) { return double(count); });
+			measure<SingleValueQueue<TimestampedValue>>("sequence lock, timestamped value", writerCount, pause,
+				[](std::uint64_t count) { return TimestampedValue { double(count), std::int64_t(count) }; });
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Lets the tasks of an I/O component update their data points until the data points are invalidated
+///
+/// Every task that reads data and commits it to data points holds a @ref Pass while it does so. Closing the gate waits
+/// for all passes that are still held, and turns away all later ones, so that no read can overwrite the "No Data" state
+/// the data points are set to at shutdown.
+class AcquisitionGate final
+{
+public:
+	/// @brief Holds the gate open for the lifetime of the object, if it was not closed yet
+	class Pass final
+	{
+	public:
+		/// @brief Enters the gate
+		explicit Pass(AcquisitionGate &gate) noexcept : _gate(gate.enter() ? &gate : nullptr)
+		{
+		}
+
+		/// @brief Leaves the gate again
+		~Pass()
+		{
+			if (_gate)
+			{
+				_gate->leave();
+			}
+		}
+
+		/// @brief Deleted copy constructor
+		Pass(const Pass &) = delete;
+		/// @brief Deleted assignment operator
+		auto operator=(const Pass &) -> Pass & = delete;
+
+		/// @brief Returns whether the gate was still open, and data may be acquired
+		explicit operator bool() const noexcept
+		{
+			return _gate != nullptr;
+		}
+
+	private:
+		/// @brief The gate, or nullptr if it was already closed
+		AcquisitionGate *_gate;
+	};
+
+	/// @brief Closes the gate, and waits for all passes still held to be released
+	///
+	/// Passes are only held for the duration of a single read, so this does not wait long.
+	auto close() noexcept -> void
+	{
+		_state.fetch_or(kClosed, std::memory_order_acq_rel);
+		while ((_state.load(std::memory_order_acquire) & ~kClosed) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	/// @brief Enters the gate, unless it is closed
+	auto enter() noexcept -> bool
+	{
+		if ((_state.fetch_add(1, std::memory_order_acquire) & kClosed) != 0)
+		{
+			leave();
+			return false;
+		}
+		return true;
+	}
+
+	/// @brief Leaves the gate
+	auto leave() noexcept -> void
+	{
+		_state.fetch_sub(1, std::memory_order_release);
+	}
+
+	/// @brief The bit in the state that marks the gate as closed
+	static constexpr std::uint64_t kClosed = std::uint64_t(1) << 63;
+
+	/// @brief The closed bit, and the number of passes held in the remaining bits
+	std::atomic<std::uint64_t> _state { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,110 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Adapts the rate at which a data point is read to how much its value changes.
+///
+/// The data point starts out at the minimum interval. Each time the value changes by more than the dead band, the
+/// interval is halved, and if it changes by much more than the dead band, it drops to the minimum interval right away.
+/// Each time the value stays within the dead band, the interval grows by a quarter, up to the maximum interval. This
+/// makes the polling ramp up quickly on activity, and back off gradually when the signal is quiet.
+///
+/// The reads themselves are still triggered by the "read" task, which should be scheduled at the minimum interval.
+/// Reads that are not due yet are simply skipped.
+///
+/// The object has a fixed size and never allocates memory, so it can be used on the read path.
+class AdaptivePolling final
+{
+public:
+	/// @brief Creates an object that adapts between two intervals
+	/// @param minimumInterval The shortest interval, used while the value is changing
+	/// @param maximumInterval The longest interval, used while the value is quiet
+	/// @param deadBand The largest change in value that is still considered quiet
+	AdaptivePolling(std::chrono::nanoseconds minimumInterval, std::chrono::nanoseconds maximumInterval, double deadBand) noexcept :
+		_minimumInterval(minimumInterval),
+		_maximumInterval(maximumInterval),
+		_deadBand(deadBand),
+		_interval(minimumInterval)
+	{
+	}
+
+	/// @brief Returns the current interval
+	auto interval() const noexcept -> std::chrono::nanoseconds
+	{
+		return _interval;
+	}
+
+	/// @brief Checks whether a read is due
+	/// @param scheduledTime The scheduled time of the "read" task
+	auto due(std::chrono::system_clock::time_point scheduledTime) const noexcept -> bool
+	{
+		return scheduledTime >= _nextRead;
+	}
+
+	/// @brief Adapts the interval to a newly read value
+	/// @param timeStamp The time stamp of the read
+	/// @param value The value that was read
+	auto observe(std::chrono::system_clock::time_point timeStamp, double value) noexcept -> void
+	{
+		// The first value after an error always counts as a large change
+		const auto change = _hasValue ? std::abs(value - _lastValue) : std::numeric_limits<double>::infinity();
+		_lastValue = value;
+		_hasValue = true;
+
+		if (change > _deadBand * kJumpFactor)
+		{
+			_interval = _minimumInterval;
+		}
+		else if (change > _deadBand)
+		{
+			_interval = std::max(_minimumInterval, _interval / 2);
+		}
+		else
+		{
+			_interval = std::min(_maximumInterval, _interval + _interval / 4);
+		}
+
+		_nextRead = timeStamp + _interval;
+	}
+
+	/// @brief Adapts the interval to a read error
+	///
+	/// The data point is read at the minimum interval until it can be read successfully again.
+	/// @param timeStamp The time stamp of the read
+	auto observeError(std::chrono::system_clock::time_point timeStamp) noexcept -> void
+	{
+		_hasValue = false;
+		_interval = _minimumInterval;
+		_nextRead = timeStamp + _interval;
+	}
+
+private:
+	/// @brief A change of more than this many times the dead band drops the interval to the minimum right away
+	static constexpr double kJumpFactor { 4.0 };
+
+	/// @brief The shortest interval
+	std::chrono::nanoseconds _minimumInterval;
+	/// @brief The longest interval
+	std::chrono::nanoseconds _maximumInterval;
+	/// @brief The largest change in value that is still considered quiet
+	double _deadBand;
+
+	/// @brief The current interval
+	std::chrono::nanoseconds _interval;
+	/// @brief The time at which the next read is due
+	std::chrono::system_clock::time_point _nextRead { std::chrono::system_clock::time_point::min() };
+
+	/// @brief The last value that was read
+	double _lastValue { 0.0 };
+	/// @brief Whether _lastValue is valid
+	bool _hasValue { false };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -2,12 +2,102 @@
 #include "Attributes.hpp"
 
 #include <xentara/data/DataType.hpp>
+#include <xentara/utils/core/Uuid.hpp>
+
+#include <string_view>
 
 namespace xentara::plugins::templateDriver::attributes
 {
 
+using namespace std::literals;
+using namespace xentara::literals;
+
 const model::Attribute kError { model::Attribute::kError, model::Attribute::Access::ReadOnly, data::DataType::kErrorCode };
 
 const model::Attribute kWriteError { model::Attribute::kWriteError, model::Attribute::Access::ReadOnly, data::DataType::kErrorCode };
 
-} // namespace xentara::plugins::templateDriver::attributes
+/// @todo assign a unique UUID
+const model::Attribute kStale { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "stale"sv, model::Attribute::Access::ReadOnly, data::DataType::kBoolean };
+
+/// @todo assign a unique UUID
+const model::Attribute kMinimum { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "minimum"sv, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
+
+/// @todo assign a unique UUID
+const model::Attribute kMaximum { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "maximum"sv, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
+
+/// @todo assign a unique UUID
+const model::Attribute kMean { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "mean"sv, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
+
+/// @todo assign a unique UUID
+const model::Attribute kRms { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "rms"sv, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
+
+/// @todo assign a unique UUID
+const model::Attribute kSampleCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "sampleCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kPollInterval { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "pollInterval"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kAlarmState { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "alarmState"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kPendingInitialReads { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "pendingInitialReads"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kFirstValueTimeMedian { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "firstValueTimeMedian"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kFirstValueTimeP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "firstValueTimeP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kFirstValueTimeMax { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "firstValueTimeMax"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteLatency { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteLatencyP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeLatencyP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kHedgedReads { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "hedgedReads"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kSecondaryWinRatio { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "secondaryWinRatio"sv, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadLatencyP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readLatencyP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kDumpTrace { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "dumpTrace"sv, model::Attribute::Access::WriteOnly, data::DataType::kBoolean };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadStartDelayP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readStartDelayP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadStartDelayMax { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readStartDelayMax"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadExecutionTimeP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readExecutionTimeP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadExecutionTimeMax { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readExecutionTimeMax"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadOverruns { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readOverruns"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteStartDelayP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeStartDelayP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteStartDelayMax { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeStartDelayMax"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteExecutionTimeP99 { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeExecutionTimeP99"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteExecutionTimeMax { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeExecutionTimeMax"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteOverruns { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "writeOverruns"sv, model::Attribute::Access::ReadOnly, data::DataType::kUnsignedInteger };
+
+} // namespace xentara::plugins::templateDriver::attributes
\ No newline at end of file
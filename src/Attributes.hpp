@@ -12,4 +12,71 @@ extern const model::Attribute kError;
 /// @brief A Xentara attribute containing a write error code for a data point
 extern const model::Attribute kWriteError;
 
+/// @brief A Xentara attribute that indicates that the value of a data point is stale, because reads were deferred
+extern const model::Attribute kStale;
+
+/// @brief A Xentara attribute containing the smallest sample of the last sampling interval
+extern const model::Attribute kMinimum;
+/// @brief A Xentara attribute containing the largest sample of the last sampling interval
+extern const model::Attribute kMaximum;
+/// @brief A Xentara attribute containing the mean of the samples of the last sampling interval
+extern const model::Attribute kMean;
+/// @brief A Xentara attribute containing the root mean square of the samples of the last sampling interval
+extern const model::Attribute kRms;
+/// @brief A Xentara attribute containing the number of samples taken in the last sampling interval
+extern const model::Attribute kSampleCount;
+
+/// @brief A Xentara attribute containing the current interval between reads of an adaptively polled data point, in nanoseconds
+extern const model::Attribute kPollInterval;
+
+/// @brief A Xentara attribute containing the alarm state of a data point with limits: 0 if the value is within the limits,
+/// 1 or 2 if the high or high-high limit is violated, and -1 or -2 if the low or low-low limit is violated
+extern const model::Attribute kAlarmState;
+
+/// @brief A Xentara attribute containing the number of initial reads of an I/O component that have not completed yet
+extern const model::Attribute kPendingInitialReads;
+/// @brief A Xentara attribute containing the median time until a data point received its first valid value, in nanoseconds
+extern const model::Attribute kFirstValueTimeMedian;
+/// @brief A Xentara attribute containing the 99th percentile of the time until a data point received its first valid value, in nanoseconds
+extern const model::Attribute kFirstValueTimeP99;
+/// @brief A Xentara attribute containing the longest time until a data point received its first valid value, in nanoseconds
+extern const model::Attribute kFirstValueTimeMax;
+
+/// @brief A Xentara attribute containing the time between scheduling and writing the last value, in nanoseconds
+extern const model::Attribute kWriteLatency;
+/// @brief A Xentara attribute containing the 99th percentile of the time between scheduling and writing values, in nanoseconds
+extern const model::Attribute kWriteLatencyP99;
+
+/// @brief A Xentara attribute containing the number of reads of an I/O component that were sent on both redundant paths
+extern const model::Attribute kHedgedReads;
+/// @brief A Xentara attribute containing the share of successful reads of an I/O component that were won by the secondary path
+extern const model::Attribute kSecondaryWinRatio;
+/// @brief A Xentara attribute containing the 99th percentile of the read latency of an I/O component, in nanoseconds
+extern const model::Attribute kReadLatencyP99;
+
+/// @brief A writable Xentara attribute that requests a dump of the execution trace when set to true
+extern const model::Attribute kDumpTrace;
+
+/// @brief A Xentara attribute containing the 99th percentile of the delay between the scheduled and actual start of the "read" task, in nanoseconds
+extern const model::Attribute kReadStartDelayP99;
+/// @brief A Xentara attribute containing the longest delay between the scheduled and actual start of the "read" task, in nanoseconds
+extern const model::Attribute kReadStartDelayMax;
+/// @brief A Xentara attribute containing the 99th percentile of the execution time of the "read" task, in nanoseconds
+extern const model::Attribute kReadExecutionTimeP99;
+/// @brief A Xentara attribute containing the longest execution time of the "read" task, in nanoseconds
+extern const model::Attribute kReadExecutionTimeMax;
+/// @brief A Xentara attribute containing the number of times the "read" task did not finish before its next cycle was due
+extern const model::Attribute kReadOverruns;
+
+/// @brief A Xentara attribute containing the 99th percentile of the delay between the scheduled and actual start of the "write" task, in nanoseconds
+extern const model::Attribute kWriteStartDelayP99;
+/// @brief A Xentara attribute containing the longest delay between the scheduled and actual start of the "write" task, in nanoseconds
+extern const model::Attribute kWriteStartDelayMax;
+/// @brief A Xentara attribute containing the 99th percentile of the execution time of the "write" task, in nanoseconds
+extern const model::Attribute kWriteExecutionTimeP99;
+/// @brief A Xentara attribute containing the longest execution time of the "write" task, in nanoseconds
+extern const model::Attribute kWriteExecutionTimeMax;
+/// @brief A Xentara attribute containing the number of times the "write" task did not finish before its next cycle was due
+extern const model::Attribute kWriteOverruns;
+
 } // namespace xentara::plugins::templateDriver::attributes
\ No newline at end of file
@@ -0,0 +1,282 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/data/Quality.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A bounded journal of value changes that readers can follow without taking a lock.
+///
+/// The journal is a ring buffer of entries, each of which carries a sequence number. Any number of readers can follow
+/// the journal independently using their own @ref Cursor, and only ever see the changes that occurred since they last
+/// looked. If the writer overtakes a reader, the reader is told so explicitly and can tell how many entries it missed.
+///
+/// Each entry is protected by its own sequence lock, so readers never block the writer, and the writer never waits
+/// for readers.
+///
+/// @note The journal is not lock-free for writers. Concurrent calls to append() are serialized using a spin lock that
+/// only covers the few stores needed to fill in a single entry. Readers never take the lock.
+template <typename DataType>
+	requires std::is_trivially_copyable_v<DataType>
+class ChangeJournal final
+{
+public:
+	/// @brief A single entry of the journal
+	struct Entry final
+	{
+		/// @brief The sequence number of the entry. The first entry ever appended has the sequence number 1.
+		std::uint64_t _sequence { 0 };
+		/// @brief The index of the data point that changed within its I/O component
+		std::size_t _pointIndex { 0 };
+		/// @brief The time stamp of the change
+		std::chrono::system_clock::time_point _timeStamp;
+		/// @brief The new value
+		DataType _value {};
+		/// @brief The new quality
+		data::Quality _quality { data::Quality::Bad };
+	};
+
+	/// @brief The result of a read operation
+	enum class ReadResult
+	{
+		/// @brief An entry was read
+		Entry,
+		/// @brief There are no new entries
+		Empty,
+		/// @brief The writer overtook the reader. The cursor has been moved to the oldest entry still in the journal.
+		Overrun
+	};
+
+	/// @brief The read position of a single reader within the journal
+	class Cursor final
+	{
+	public:
+		/// @brief Returns the sequence number of the next entry that will be read
+		auto position() const noexcept -> std::uint64_t
+		{
+			return _next;
+		}
+
+		/// @brief Returns the total number of entries this reader missed because the writer overtook it
+		auto missed() const noexcept -> std::uint64_t
+		{
+			return _missed;
+		}
+
+	private:
+		/// @brief The journal needs to access the position
+		friend class ChangeJournal<DataType>;
+
+		/// @brief The sequence number of the next entry to read
+		std::uint64_t _next { 1 };
+		/// @brief The number of entries missed so far
+		std::uint64_t _missed { 0 };
+	};
+
+	/// @brief Creates a journal with at least the given number of entries.
+	/// @param capacity The minimum number of entries. This is rounded up to the next power of two.
+	explicit ChangeJournal(std::size_t capacity) :
+		_capacity(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+		_slots(std::make_unique<Slot[]>(_capacity))
+	{
+	}
+
+	/// @brief Returns the number of entries the journal can hold
+	auto capacity() const noexcept -> std::size_t
+	{
+		return _capacity;
+	}
+
+	/// @brief Returns the sequence number of the newest entry, or 0 if the journal is empty
+	auto newestSequence() const noexcept -> std::uint64_t
+	{
+		return _newest.load(std::memory_order_acquire);
+	}
+
+	/// @brief Creates a cursor that will only see entries appended after this call
+	auto makeCursor() const noexcept -> Cursor
+	{
+		Cursor cursor;
+		cursor._next = newestSequence() + 1;
+		return cursor;
+	}
+
+	/// @brief Appends an entry to the journal, overwriting the oldest entry if the journal is full.
+	/// @param pointIndex The index of the data point within the I/O component
+	/// @param timeStamp The time stamp of the change
+	/// @param value The new value
+	/// @param quality The new quality
+	auto append(std::size_t pointIndex,
+		std::chrono::system_clock::time_point timeStamp,
+		const DataType &value,
+		data::Quality quality) noexcept -> void;
+
+	/// @brief Reads the next entry for a reader
+	/// @param cursor The cursor of the reader. This is advanced if an entry was read, and moved to the oldest
+	/// available entry on overrun.
+	/// @param entry Receives the entry, if one was read
+	/// @return The result of the read operation
+	auto read(Cursor &cursor, Entry &entry) const noexcept -> ReadResult;
+
+	/// @brief Calls a function for all new entries of a reader
+	/// @param cursor The cursor of the reader
+	/// @param function The function to call. It is called with a const reference to each entry.
+	/// @return The number of entries missed due to overruns during this call
+	template <std::invocable<const Entry &> Function>
+	auto forEachNewEntry(Cursor &cursor, Function &&function) const -> std::uint64_t;
+
+private:
+	/// @brief The marker placed in the sequence number of a slot while it is being written
+	static constexpr std::uint64_t kWriting = ~std::uint64_t(0);
+
+	/// @brief A slot in the ring buffer.
+	///
+	/// The payload is stored using atomics with relaxed ordering, so that a reader racing with the writer reads a
+	/// torn entry instead of invoking undefined behaviour. Torn entries are detected using the sequence number.
+	struct Slot final
+	{
+		/// @brief The sequence number of the entry in the slot, 0 if the slot was never written, or kWriting.
+		std::atomic<std::uint64_t> _sequence { 0 };
+		/// @brief The index of the data point
+		std::atomic<std::size_t> _pointIndex { 0 };
+		/// @brief The time stamp, in system clock ticks since the epoch
+		std::atomic<std::chrono::system_clock::rep> _timeStamp { 0 };
+		/// @brief The value
+		std::atomic<DataType> _value {};
+		/// @brief The quality
+		std::atomic<data::Quality> _quality { data::Quality::Bad };
+	};
+
+	/// @brief The number of slots. This is always a power of two.
+	std::size_t _capacity;
+	/// @brief The slots
+	std::unique_ptr<Slot[]> _slots;
+
+	/// @brief The sequence number of the newest published entry. This is on its own cache line, because all readers
+	/// poll it.
+	alignas(64) std::atomic<std::uint64_t> _newest { 0 };
+	/// @brief The lock that serializes writers
+	std::atomic_flag _writeLock;
+};
+
+template <typename DataType>
+	requires std::is_trivially_copyable_v<DataType>
+auto ChangeJournal<DataType>::append(std::size_t pointIndex,
+	std::chrono::system_clock::time_point timeStamp,
+	const DataType &value,
+	data::Quality quality) noexcept -> void
+{
+	// Serialize writers
+	while (_writeLock.test_and_set(std::memory_order_acquire))
+	{
+	}
+
+	const auto sequence = _newest.load(std::memory_order_relaxed) + 1;
+	auto &slot = _slots[sequence & (_capacity - 1)];
+
+	// Mark the slot as being written, so that readers of the entry being overwritten notice
+	slot._sequence.store(kWriting, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	// Fill in the payload
+	slot._pointIndex.store(pointIndex, std::memory_order_relaxed);
+	slot._timeStamp.store(timeStamp.time_since_epoch().count(), std::memory_order_relaxed);
+	slot._value.store(value, std::memory_order_relaxed);
+	slot._quality.store(quality, std::memory_order_relaxed);
+
+	// Publish the entry
+	slot._sequence.store(sequence, std::memory_order_release);
+	_newest.store(sequence, std::memory_order_release);
+
+	_writeLock.clear(std::memory_order_release);
+}
+
+template <typename DataType>
+	requires std::is_trivially_copyable_v<DataType>
+auto ChangeJournal<DataType>::read(Cursor &cursor, Entry &entry) const noexcept -> ReadResult
+{
+	const auto newest = _newest.load(std::memory_order_acquire);
+
+	// Check if there is anything new
+	if (cursor._next > newest)
+	{
+		return ReadResult::Empty;
+	}
+
+	// Moves the cursor past the lost entry to the oldest entry still in the journal
+	auto recover = [&]() {
+		const auto latest = _newest.load(std::memory_order_acquire);
+		const auto oldest = latest >= _capacity ? latest - _capacity + 1 : 1;
+		const auto next = std::max(oldest, cursor._next + 1);
+		cursor._missed += next - cursor._next;
+		cursor._next = next;
+		return ReadResult::Overrun;
+	};
+
+	// Check if the entry was overwritten already
+	if (newest - cursor._next >= _capacity)
+	{
+		return recover();
+	}
+
+	const auto &slot = _slots[cursor._next & (_capacity - 1)];
+
+	// Read the payload under the sequence lock
+	if (slot._sequence.load(std::memory_order_acquire) != cursor._next)
+	{
+		return recover();
+	}
+	entry._pointIndex = slot._pointIndex.load(std::memory_order_relaxed);
+	entry._timeStamp = std::chrono::system_clock::time_point(
+		std::chrono::system_clock::duration(slot._timeStamp.load(std::memory_order_relaxed)));
+	entry._value = slot._value.load(std::memory_order_relaxed);
+	entry._quality = slot._quality.load(std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (slot._sequence.load(std::memory_order_relaxed) != cursor._next)
+	{
+		return recover();
+	}
+
+	entry._sequence = cursor._next++;
+	return ReadResult::Entry;
+}
+
+template <typename DataType>
+	requires std::is_trivially_copyable_v<DataType>
+template <std::invocable<const typename ChangeJournal<DataType>::Entry &> Function>
+auto ChangeJournal<DataType>::forEachNewEntry(Cursor &cursor, Function &&function) const -> std::uint64_t
+{
+	const auto missedBefore = cursor._missed;
+
+	Entry entry;
+	for (;;)
+	{
+		switch (read(cursor, entry))
+		{
+		case ReadResult::Entry:
+			function(std::as_const(entry));
+			break;
+
+		case ReadResult::Overrun:
+			// Just continue with the oldest entry
+			break;
+
+		case ReadResult::Empty:
+			return cursor._missed - missedBefore;
+		}
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,66 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/process/Task.hpp>
+#include <xentara/process/ExecutionContext.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief This class providing callbacks for the Xentara scheduler for the "checkpoint" task of I/O components
+template <typename Target>
+class CheckpointTask final : public process::Task
+{
+public:
+	/// @brief This constuctor attached the task to its target
+	CheckpointTask(std::reference_wrapper<Target> target) : _target(target)
+	{
+	}
+
+	/// @name Virtual Overrides for process::Task
+	/// @{
+
+	auto stages() const -> Stages final
+	{
+		return Stage::Operational | Stage::PostOperational;
+	}
+
+	auto operational(const process::ExecutionContext &context) -> void final;
+
+	auto preparePostOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto postOperational(const process::ExecutionContext &context) -> Status final;
+		
+	/// @}
+
+private:
+	/// @brief A reference to the target element
+	std::reference_wrapper<Target> _target;
+};
+
+template <typename Target>
+auto CheckpointTask<Target>::operational(const process::ExecutionContext &context) -> void
+{
+	_target.get().performCheckpointTask(context);
+}
+
+template <typename Target>
+auto CheckpointTask<Target>::preparePostOperational(const process::ExecutionContext &context) -> Status
+{
+	// Everything in the post operational stage is optional, so we can report ready right away
+	return Status::Ready;
+}
+
+template <typename Target>
+auto CheckpointTask<Target>::postOperational(const process::ExecutionContext &context) -> Status
+{
+	// Take one last checkpoint, so that the newest values are available on the next startup
+	operational(context);
+
+	return Status::Ready;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Copyright (c) embedded ocean GmbH
+#include "CompactEncoding.hpp"
+
+#include "CustomError.hpp"
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief The smallest time stamp that can be encoded. The value below it is reserved for kNever.
+	constexpr std::int64_t kMinimumTimeStamp = -(std::int64_t(1) << 47) + 1;
+	/// @brief The largest time stamp that can be encoded
+	constexpr std::int64_t kMaximumTimeStamp = (std::int64_t(1) << 47) - 1;
+
+} // namespace
+
+CompactEncoding::CompactEncoding() :
+	_epoch(std::chrono::floor<std::chrono::microseconds>(std::chrono::system_clock::now())),
+	_errors(std::make_unique<Error[]>(kMaxErrors))
+{
+	// Fill in the errors with fixed indices
+	append({});
+	append(CustomError::NoData);
+	append(CustomError::UnknownError);
+}
+
+auto CompactEncoding::encode(std::chrono::system_clock::time_point timeStamp) const noexcept -> TimeStamp
+{
+	if (timeStamp == std::chrono::system_clock::time_point::min())
+	{
+		return kNever;
+	}
+
+	// Get the number of microseconds since the epoch, limited to what fits into 48 bits
+	const auto microseconds = std::clamp<std::int64_t>(
+		std::chrono::floor<std::chrono::microseconds>(timeStamp - _epoch).count(), kMinimumTimeStamp, kMaximumTimeStamp);
+
+	const auto bits = std::uint64_t(microseconds);
+	return { std::uint16_t(bits), std::uint16_t(bits >> 16), std::uint16_t(bits >> 32) };
+}
+
+auto CompactEncoding::decode(const TimeStamp &timeStamp) const noexcept -> std::chrono::system_clock::time_point
+{
+	if (timeStamp == kNever)
+	{
+		return std::chrono::system_clock::time_point::min();
+	}
+
+	// Assemble the 48 bits, and sign extend them
+	const auto bits = std::uint64_t(timeStamp[0]) | (std::uint64_t(timeStamp[1]) << 16) | (std::uint64_t(timeStamp[2]) << 32);
+	const auto microseconds = std::int64_t(bits << 16) >> 16;
+
+	return _epoch + std::chrono::microseconds(microseconds);
+}
+
+auto CompactEncoding::intern(std::error_code error) noexcept -> ErrorIndex
+{
+	// "No error" has a fixed index
+	if (!error)
+	{
+		return kNoError;
+	}
+
+	// Look the error up without locking. There are usually only a handful of distinct errors.
+	const auto find = [&](std::size_t count) -> std::size_t {
+		for (std::size_t index = kNoError + 1; index < count; ++index)
+		{
+			if (_errors[index]._value == error.value() && *_errors[index]._category == error.category())
+			{
+				return index;
+			}
+		}
+		return count;
+	};
+	auto count = _errorCount.load(std::memory_order_acquire);
+	if (const auto index = find(count); index < count)
+	{
+		return ErrorIndex(index);
+	}
+
+	// Look again while holding the lock, in case another thread interned the error in the meantime
+	const std::scoped_lock lock { _internMutex };
+	count = _errorCount.load(std::memory_order_relaxed);
+	if (const auto index = find(count); index < count)
+	{
+		return ErrorIndex(index);
+	}
+
+	// Add the error to the table, if it still fits
+	if (count == kMaxErrors)
+	{
+		return kUnknownError;
+	}
+	return append(error);
+}
+
+auto CompactEncoding::error(ErrorIndex index) const noexcept -> std::error_code
+{
+	const auto &error = _errors[index];
+	if (!error._category)
+	{
+		return {};
+	}
+
+	return { error._value, *error._category };
+}
+
+auto CompactEncoding::append(std::error_code error) noexcept -> ErrorIndex
+{
+	const auto index = _errorCount.load(std::memory_order_relaxed);
+
+	// "No error" is stored without a category
+	if (error)
+	{
+		_errors[index] = { &error.category(), error.value() };
+	}
+
+	// Publish the entry only once it is filled in
+	_errorCount.store(index + 1, std::memory_order_release);
+	return ErrorIndex(index);
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
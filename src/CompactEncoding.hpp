@@ -0,0 +1,88 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Encodes the time stamps and errors of data points in compact form
+///
+/// Time stamps are stored as signed 48-bit counts of microseconds relative to an epoch, which covers more than four
+/// years in either direction. Errors are interned in a table, and stored as 16-bit indices into the table. The encoding
+/// is shared by all data points of an I/O component, so the table only contains each distinct error once.
+///
+/// @note Errors can be interned and decoded from any thread. Decoding never takes a lock, and interning only takes a
+/// lock the first time an error is encountered. Neither allocates any memory.
+class CompactEncoding final
+{
+public:
+	/// @brief An encoded time stamp
+	using TimeStamp = std::array<std::uint16_t, 3>;
+	/// @brief The index of an interned error
+	using ErrorIndex = std::uint16_t;
+
+	/// @brief The encoding of std::chrono::system_clock::time_point::min(), which is used for "never"
+	static constexpr TimeStamp kNever { 0, 0, 0x8000 };
+
+	/// @brief The index of the "no error" error code
+	static constexpr ErrorIndex kNoError = 0;
+	/// @brief The index of CustomError::NoData, which is interned up front
+	static constexpr ErrorIndex kNoData = 1;
+	/// @brief The index of CustomError::UnknownError, which is used for errors that no longer fit into the table
+	static constexpr ErrorIndex kUnknownError = 2;
+
+	/// @brief The maximum number of distinct errors, including "no error"
+	static constexpr std::size_t kMaxErrors = 1024;
+
+	/// @brief Creates an encoding that uses the current time as epoch
+	CompactEncoding();
+
+	/// @brief Encodes a time stamp
+	///
+	/// The time stamp is rounded down to a whole microsecond, and limited to the range that can be encoded.
+	auto encode(std::chrono::system_clock::time_point timeStamp) const noexcept -> TimeStamp;
+
+	/// @brief Decodes a time stamp
+	auto decode(const TimeStamp &timeStamp) const noexcept -> std::chrono::system_clock::time_point;
+
+	/// @brief Interns an error
+	/// @return The index of the error in the table
+	auto intern(std::error_code error) noexcept -> ErrorIndex;
+
+	/// @brief Returns an interned error
+	/// @param index An index returned by intern()
+	auto error(ErrorIndex index) const noexcept -> std::error_code;
+
+private:
+	/// @brief An interned error
+	struct Error final
+	{
+		/// @brief The category of the error
+		const std::error_category *_category { nullptr };
+		/// @brief The value of the error
+		int _value { 0 };
+	};
+
+	/// @brief Appends an error to the table. The caller must hold the lock, and make sure the table is not full.
+	auto append(std::error_code error) noexcept -> ErrorIndex;
+
+	/// @brief The epoch
+	std::chrono::system_clock::time_point _epoch;
+
+	/// @brief The interned errors. The table never grows, so that entries can be read without locking.
+	std::unique_ptr<Error[]> _errors;
+	/// @brief The number of interned errors
+	std::atomic<std::size_t> _errorCount { 0 };
+	/// @brief A lock that serializes the interning of new errors
+	std::mutex _internMutex;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,340 @@
+// Copyright (c) embedded ocean GmbH
+#include "CompressedHistory.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief The maximum number of bits a single sample can take up. This is 5 + 64 bits for the time stamp,
+	/// and 2 + 5 + 6 + 64 bits for the value.
+	constexpr std::size_t kMaxBitsPerSample = 146;
+
+	/// @brief The number of bits in a block
+	constexpr std::size_t kBitsPerBlock = CompressedHistory::kWordsPerBlock * 64;
+
+	/// @brief Creates a mask for the lowest bits of a word
+	constexpr auto lowMask(unsigned count) noexcept -> std::uint64_t
+	{
+		return count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+	}
+
+	/// @brief Checks whether a signed value can be represented using a certain number of bits
+	constexpr auto fitsSigned(std::int64_t value, unsigned bits) noexcept -> bool
+	{
+		const auto limit = std::int64_t(1) << (bits - 1);
+		return value >= -limit && value < limit;
+	}
+
+	/// @brief Sign extends a value of a certain number of bits
+	constexpr auto signExtend(std::uint64_t value, unsigned bits) noexcept -> std::int64_t
+	{
+		const auto shift = 64 - bits;
+		return std::int64_t(value << shift) >> shift;
+	}
+
+	/// @brief Converts a time stamp to microseconds since the epoch
+	auto toMicroseconds(std::chrono::system_clock::time_point timeStamp) noexcept -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(timeStamp.time_since_epoch()).count();
+	}
+
+	/// @brief Reads bits from a copy of a block
+	class BitReader final
+	{
+	public:
+		/// @brief Constructor
+		BitReader(const std::array<std::uint64_t, CompressedHistory::kWordsPerBlock> &words) noexcept : _words(words)
+		{
+		}
+
+		/// @brief Reads a number of bits in the range 1 to 64
+		auto read(unsigned count) noexcept -> std::uint64_t
+		{
+			const auto word = _position / 64;
+			const auto offset = unsigned(_position % 64);
+			auto bits = _words[word] >> offset;
+			if (offset + count > 64 && word + 1 < _words.size())
+			{
+				bits |= _words[word + 1] << (64 - offset);
+			}
+			_position += count;
+			return bits & lowMask(count);
+		}
+
+		/// @brief Reads a single bit
+		auto readBit() noexcept -> bool
+		{
+			return read(1) != 0;
+		}
+
+	private:
+		/// @brief The words
+		const std::array<std::uint64_t, CompressedHistory::kWordsPerBlock> &_words;
+		/// @brief The current bit position
+		std::size_t _position { 0 };
+	};
+
+} // namespace
+
+CompressedHistory::CompressedHistory(std::size_t blockCount) :
+	_blockCount(std::max<std::size_t>(blockCount, 2)),
+	_blocks(std::make_unique<Block[]>(_blockCount))
+{
+}
+
+auto CompressedHistory::append(std::chrono::system_clock::time_point timeStamp, double value) noexcept -> void
+{
+	const auto time = toMicroseconds(timeStamp);
+	const auto valueBits = std::bit_cast<std::uint64_t>(value);
+
+	// Move on to the next block if the current one might not have enough space left
+	if (kBitsPerBlock - _bitPosition < kMaxBitsPerSample)
+	{
+		const auto next = (_currentBlock.load(std::memory_order_relaxed) + 1) % _blockCount;
+		recycle(_blocks[next]);
+		_currentBlock.store(next, std::memory_order_release);
+		_bitPosition = 0;
+		_blockSamples = 0;
+	}
+
+	const auto startPosition = _bitPosition;
+
+	// The first sample in a block is stored verbatim, so that each block can be decoded on its own
+	if (_blockSamples == 0)
+	{
+		writeBits(std::uint64_t(time), 64);
+		writeBits(valueBits, 64);
+		_previousDelta = 0;
+		_previousLeading = 64;
+		_previousTrailing = 0;
+	}
+	else
+	{
+		const auto delta = time - _previousTime;
+		writeTimeStamp(delta - _previousDelta);
+		writeValue(valueBits ^ _previousValue);
+		_previousDelta = delta;
+	}
+
+	_previousTime = time;
+	_previousValue = valueBits;
+
+	// Publish the sample
+	_blocks[_currentBlock.load(std::memory_order_relaxed)]._sampleCount.store(++_blockSamples, std::memory_order_release);
+
+	_totalSamples.fetch_add(1, std::memory_order_relaxed);
+	_totalBits.fetch_add(_bitPosition - startPosition, std::memory_order_relaxed);
+}
+
+auto CompressedHistory::snapshot(std::vector<Sample> &samples) const -> void
+{
+	samples.clear();
+
+	std::array<std::uint64_t, kWordsPerBlock> words;
+
+	// Go through the blocks from oldest to newest
+	const auto current = _currentBlock.load(std::memory_order_acquire);
+	for (std::size_t step = 1; step <= _blockCount; ++step)
+	{
+		const auto &block = _blocks[(current + step) % _blockCount];
+
+		// Skip blocks that are being recycled
+		const auto generation = block._generation.load(std::memory_order_acquire);
+		if (generation % 2 != 0)
+		{
+			continue;
+		}
+
+		// Copy the data
+		const auto sampleCount = block._sampleCount.load(std::memory_order_acquire);
+		if (sampleCount == 0)
+		{
+			continue;
+		}
+		std::ranges::transform(
+			block._words, words.begin(), [](const auto &word) { return word.load(std::memory_order_relaxed); });
+
+		// If the block was recycled while we were copying it, the samples are gone
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (block._generation.load(std::memory_order_relaxed) != generation)
+		{
+			continue;
+		}
+
+		decode(words, sampleCount, samples);
+	}
+}
+
+auto CompressedHistory::recycle(Block &block) noexcept -> void
+{
+	const auto generation = block._generation.load(std::memory_order_relaxed);
+
+	// Mark the block as being recycled
+	block._generation.store(generation + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	block._sampleCount.store(0, std::memory_order_relaxed);
+	for (auto &word : block._words)
+	{
+		word.store(0, std::memory_order_relaxed);
+	}
+
+	// Mark the block as ready
+	block._generation.store(generation + 2, std::memory_order_release);
+}
+
+auto CompressedHistory::writeBits(std::uint64_t bits, unsigned count) noexcept -> void
+{
+	auto &words = _blocks[_currentBlock.load(std::memory_order_relaxed)]._words;
+
+	const auto word = _bitPosition / 64;
+	const auto offset = unsigned(_bitPosition % 64);
+
+	// Only the writer modifies the words, so a relaxed load and store is sufficient
+	words[word].store(words[word].load(std::memory_order_relaxed) | (bits << offset), std::memory_order_relaxed);
+	if (offset + count > 64)
+	{
+		words[word + 1].store(bits >> (64 - offset), std::memory_order_relaxed);
+	}
+
+	_bitPosition += count;
+}
+
+auto CompressedHistory::writeTimeStamp(std::int64_t deltaOfDelta) noexcept -> void
+{
+	// Use the smallest bucket the value fits into. The control bits are written least significant bit first.
+	if (deltaOfDelta == 0)
+	{
+		writeBits(0b0, 1);
+	}
+	else if (fitsSigned(deltaOfDelta, 7))
+	{
+		writeBits(0b01, 2);
+		writeBits(std::uint64_t(deltaOfDelta) & lowMask(7), 7);
+	}
+	else if (fitsSigned(deltaOfDelta, 9))
+	{
+		writeBits(0b011, 3);
+		writeBits(std::uint64_t(deltaOfDelta) & lowMask(9), 9);
+	}
+	else if (fitsSigned(deltaOfDelta, 12))
+	{
+		writeBits(0b0111, 4);
+		writeBits(std::uint64_t(deltaOfDelta) & lowMask(12), 12);
+	}
+	else if (fitsSigned(deltaOfDelta, 32))
+	{
+		writeBits(0b01111, 5);
+		writeBits(std::uint64_t(deltaOfDelta) & lowMask(32), 32);
+	}
+	else
+	{
+		writeBits(0b11111, 5);
+		writeBits(std::uint64_t(deltaOfDelta), 64);
+	}
+}
+
+auto CompressedHistory::writeValue(std::uint64_t xorValue) noexcept -> void
+{
+	// Identical values take up a single bit
+	if (xorValue == 0)
+	{
+		writeBits(0b0, 1);
+		return;
+	}
+
+	const auto leading = std::min(unsigned(std::countl_zero(xorValue)), 31u);
+	const auto trailing = unsigned(std::countr_zero(xorValue));
+
+	// If the meaningful bits fit into the previous window, reuse it
+	if (_previousLeading + _previousTrailing < 64 && leading >= _previousLeading && trailing >= _previousTrailing)
+	{
+		writeBits(0b01, 2);
+		writeBits(xorValue >> _previousTrailing, 64 - _previousLeading - _previousTrailing);
+		return;
+	}
+
+	// Write a new window. A length of 64 is encoded as 0.
+	const auto length = 64 - leading - trailing;
+	writeBits(0b11, 2);
+	writeBits(leading, 5);
+	writeBits(length & 63, 6);
+	writeBits(xorValue >> trailing, length);
+
+	_previousLeading = leading;
+	_previousTrailing = trailing;
+}
+
+auto CompressedHistory::decode(
+	const std::array<std::uint64_t, kWordsPerBlock> &words, std::size_t sampleCount, std::vector<Sample> &samples) -> void
+{
+	BitReader reader(words);
+
+	auto time = std::int64_t(reader.read(64));
+	auto value = reader.read(64);
+	std::int64_t delta = 0;
+	unsigned leading = 64;
+	unsigned trailing = 0;
+
+	auto emit = [&]() {
+		samples.push_back({ std::chrono::system_clock::time_point(std::chrono::microseconds(time)), std::bit_cast<double>(value) });
+	};
+
+	emit();
+
+	for (std::size_t index = 1; index < sampleCount; ++index)
+	{
+		// Decode the time stamp
+		std::int64_t deltaOfDelta = 0;
+		if (reader.readBit())
+		{
+			if (!reader.readBit())
+			{
+				deltaOfDelta = signExtend(reader.read(7), 7);
+			}
+			else if (!reader.readBit())
+			{
+				deltaOfDelta = signExtend(reader.read(9), 9);
+			}
+			else if (!reader.readBit())
+			{
+				deltaOfDelta = signExtend(reader.read(12), 12);
+			}
+			else if (!reader.readBit())
+			{
+				deltaOfDelta = signExtend(reader.read(32), 32);
+			}
+			else
+			{
+				deltaOfDelta = std::int64_t(reader.read(64));
+			}
+		}
+		delta += deltaOfDelta;
+		time += delta;
+
+		// Decode the value
+		if (reader.readBit())
+		{
+			if (reader.readBit())
+			{
+				leading = unsigned(reader.read(5));
+				auto length = unsigned(reader.read(6));
+				if (length == 0)
+				{
+					length = 64;
+				}
+				trailing = 64 - leading - length;
+			}
+			value ^= reader.read(64 - leading - trailing) << trailing;
+		}
+
+		emit();
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
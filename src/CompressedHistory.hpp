@@ -0,0 +1,146 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A bounded in-memory history of samples using Gorilla-style compression.
+///
+/// Time stamps are stored as delta-of-delta values with microsecond resolution, and values are stored as the XOR
+/// with the previous value, using the encoding described in "Gorilla: A Fast, Scalable, In-Memory Time Series Database"
+/// (Pelkonen et al., VLDB 2015). Slowly changing signals sampled at a regular rate typically need only a few bits per
+/// sample.
+///
+/// The compressed data is kept in a fixed number of fixed-size blocks that are used as a ring buffer. When all blocks
+/// are full, the oldest block is discarded as a whole. No memory is allocated after construction.
+///
+/// The history has a single writer that is never blocked. Any number of readers can take snapshots concurrently.
+/// Readers never see partially written samples, and simply skip any blocks that are recycled while they are reading them.
+class CompressedHistory final
+{
+public:
+	/// @brief A single decompressed sample
+	struct Sample final
+	{
+		/// @brief The time stamp, truncated to microseconds
+		std::chrono::system_clock::time_point _timeStamp;
+		/// @brief The value
+		double _value { 0 };
+	};
+
+	/// @brief The number of 64 bit words in a block
+	static constexpr std::size_t kWordsPerBlock = 64;
+
+	/// @brief Creates a history
+	/// @param blockCount The number of blocks to keep. Each block takes up 512 bytes of compressed data, and holds
+	/// several hundred samples for regularly sampled signals. At least two blocks are always used.
+	explicit CompressedHistory(std::size_t blockCount);
+
+	/// @brief Appends a sample
+	///
+	/// This function must only be called by one thread at a time.
+	/// @param timeStamp The time stamp of the sample
+	/// @param value The value of the sample
+	auto append(std::chrono::system_clock::time_point timeStamp, double value) noexcept -> void;
+
+	/// @brief Gets a snapshot of the samples currently in the history
+	///
+	/// This function can be called concurrently with append(), and never blocks it.
+	/// @param samples Receives the samples, oldest first. Any existing samples are cleared.
+	auto snapshot(std::vector<Sample> &samples) const -> void;
+
+	/// @brief Returns the number of bytes used for the compressed data of all blocks
+	auto capacityInBytes() const noexcept -> std::size_t
+	{
+		return _blockCount * kWordsPerBlock * sizeof(std::uint64_t);
+	}
+
+	/// @brief Returns the number of samples appended since construction, including those that were discarded
+	auto totalSamples() const noexcept -> std::uint64_t
+	{
+		return _totalSamples.load(std::memory_order_relaxed);
+	}
+
+	/// @brief Returns the number of bits used to encode all samples appended since construction
+	///
+	/// This can be used together with totalSamples() to determine the compression ratio.
+	auto totalBits() const noexcept -> std::uint64_t
+	{
+		return _totalBits.load(std::memory_order_relaxed);
+	}
+
+private:
+	/// @brief A block of compressed samples
+	struct Block final
+	{
+		/// @brief The generation of the block. This is incremented to an odd value when the block is being recycled,
+		/// and to an even value when recycling is complete.
+		std::atomic<std::uint64_t> _generation { 0 };
+		/// @brief The number of samples in the block
+		std::atomic<std::size_t> _sampleCount { 0 };
+		/// @brief The compressed data
+		std::array<std::atomic<std::uint64_t>, kWordsPerBlock> _words {};
+	};
+
+	/// @brief Clears a block so that it can be reused
+	auto recycle(Block &block) noexcept -> void;
+
+	/// @brief Writes bits to the current block
+	/// @param bits The bits to write, in the lowest bits of the value. Any higher bits must be 0.
+	/// @param count The number of bits to write, in the range 1 to 64
+	auto writeBits(std::uint64_t bits, unsigned count) noexcept -> void;
+
+	/// @brief Encodes a time stamp delta of delta
+	auto writeTimeStamp(std::int64_t deltaOfDelta) noexcept -> void;
+
+	/// @brief Encodes a value
+	auto writeValue(std::uint64_t valueBits) noexcept -> void;
+
+	/// @brief Decodes all samples from a copy of a block
+	static auto decode(
+		const std::array<std::uint64_t, kWordsPerBlock> &words, std::size_t sampleCount, std::vector<Sample> &samples) -> void;
+
+	/// @brief The number of blocks
+	std::size_t _blockCount;
+	/// @brief The blocks
+	std::unique_ptr<Block[]> _blocks;
+
+	/// @brief The index of the block currently being written to
+	std::atomic<std::size_t> _currentBlock { 0 };
+
+	/// @brief The number of samples appended since construction
+	std::atomic<std::uint64_t> _totalSamples { 0 };
+	/// @brief The number of bits written since construction
+	std::atomic<std::uint64_t> _totalBits { 0 };
+
+	/// @name Encoder State
+	/// This state is only accessed by the writer
+	/// @{
+
+	/// @brief The bit position within the current block
+	std::size_t _bitPosition { 0 };
+	/// @brief The number of samples in the current block
+	std::size_t _blockSamples { 0 };
+	/// @brief The time stamp of the previous sample, in microseconds since the epoch
+	std::int64_t _previousTime { 0 };
+	/// @brief The time stamp delta between the previous two samples, in microseconds
+	std::int64_t _previousDelta { 0 };
+	/// @brief The bit pattern of the previous value
+	std::uint64_t _previousValue { 0 };
+	/// @brief The number of leading zeros in the previous meaningful XOR window
+	unsigned _previousLeading { 0 };
+	/// @brief The number of trailing zeros in the previous meaningful XOR window
+	unsigned _previousTrailing { 0 };
+
+	/// @}
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -44,6 +44,21 @@ namespace
 		case CustomError::NoData:
 			return "no data was read yet"s;
 
+		case CustomError::RestoredValue:
+			return "the value was restored from an earlier run and has not been read yet"s;
+
+		case CustomError::StaleValue:
+			return "the value was not written because it was queued for too long"s;
+
+		case CustomError::UpdateTimeout:
+			return "the value was not updated in time"s;
+
+		case CustomError::NotConnected:
+			return "the I/O component is not connected to the device"s;
+
+		case CustomError::Busy:
+			return "too many requests are already in flight"s;
+
 		/// @todo Add messages for other error codes
 
 		case CustomError::UnknownError:
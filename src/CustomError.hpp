@@ -17,6 +17,21 @@ enum class CustomError
 	/// @brief No data has been read yet.
 	NoData,
 
+	/// @brief The value was restored from a snapshot taken during an earlier run, and has not been read yet.
+	RestoredValue,
+
+	/// @brief A value was not written because it was queued for longer than the maximum age.
+	StaleValue,
+
+	/// @brief The value was not updated within the configured update timeout.
+	UpdateTimeout,
+
+	/// @brief The I/O component is not connected to the device.
+	NotConnected,
+
+	/// @brief The request was not sent because too many requests are already in flight.
+	Busy,
+
 	/// @brief An unknown error occurred
 	UnknownError = 999
 };
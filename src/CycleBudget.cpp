@@ -0,0 +1,96 @@
+// Copyright (c) embedded ocean GmbH
+#include "CycleBudget.hpp"
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+auto CycleBudget::parsePriority(std::string_view name) noexcept -> std::optional<Priority>
+{
+	if (name == "low"sv)
+	{
+		return Priority::Low;
+	}
+	else if (name == "normal"sv)
+	{
+		return Priority::Normal;
+	}
+	else if (name == "critical"sv)
+	{
+		return Priority::Critical;
+	}
+
+	return std::nullopt;
+}
+
+auto CycleBudget::admit(Point &point, std::chrono::system_clock::time_point scheduledTime) noexcept -> bool
+{
+	// Promote data points that were deferred for too long
+	auto priority = point._priority;
+	if (point._deferredCycles >= kAgingCycles && priority != Priority::Critical)
+	{
+		priority = Priority(int(priority) + 1);
+	}
+
+	// Determine the threshold for the priority. Low priority reads are deferred when 75% of the budget are used up.
+	const auto cost = cycleCost(scheduledTime);
+	auto admitted = true;
+	switch (priority)
+	{
+	case Priority::Low:
+		admitted = cost < _budget / 4 * 3;
+		break;
+	case Priority::Normal:
+		admitted = cost < _budget;
+		break;
+	case Priority::Critical:
+		break;
+	}
+
+	// Update the deferral count
+	if (admitted)
+	{
+		point._deferredCycles = 0;
+	}
+	else
+	{
+		++point._deferredCycles;
+		_deferredReads.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return admitted;
+}
+
+auto CycleBudget::charge(std::chrono::system_clock::time_point scheduledTime, std::chrono::nanoseconds duration) noexcept -> void
+{
+	// Only charge the current cycle. Reads that finish after the next cycle has started are not counted.
+	if (_cycle.load(std::memory_order_acquire) == scheduledTime.time_since_epoch().count())
+	{
+		_cost.fetch_add(duration.count(), std::memory_order_relaxed);
+	}
+}
+
+auto CycleBudget::cycleCost(std::chrono::system_clock::time_point scheduledTime) noexcept -> std::chrono::nanoseconds
+{
+	const auto cycle = scheduledTime.time_since_epoch().count();
+
+	// Start a new cycle if this is the first read of a later cycle. Reads of an earlier cycle that are still running
+	// are measured against the current cycle.
+	auto current = _cycle.load(std::memory_order_acquire);
+	while (cycle > current)
+	{
+		if (_cycle.compare_exchange_weak(current, cycle, std::memory_order_acq_rel))
+		{
+			// A read charged between the two stores may be lost, which only makes the estimate slightly optimistic.
+			_cost.store(0, std::memory_order_relaxed);
+			return 0ns;
+		}
+	}
+
+	return std::chrono::nanoseconds(_cost.load(std::memory_order_relaxed));
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,113 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Sheds load when the reads of an I/O component exceed their cycle budget.
+///
+/// The budget tracks the time spent reading data points in the current cycle, where a cycle consists of all reads
+/// with the same scheduled time. Once the time spent approaches the budget, reads of low priority data points are
+/// deferred to later cycles, and once it exceeds the budget, reads of normal priority data points are deferred as
+/// well. Critical data points are always read.
+///
+/// To prevent starvation, a data point that was deferred for a number of consecutive cycles is treated as one
+/// priority class higher.
+class CycleBudget final
+{
+public:
+	/// @brief The priority classes of data points
+	enum class Priority
+	{
+		/// @brief The data point is deferred first
+		Low,
+		/// @brief The data point is deferred only once the budget is exceeded
+		Normal,
+		/// @brief The data point is never deferred
+		Critical
+	};
+
+	/// @brief The load shedding state of a single data point
+	class Point final
+	{
+	public:
+		/// @brief Sets the priority of the data point
+		auto setPriority(Priority priority) noexcept -> void
+		{
+			_priority = priority;
+		}
+
+		/// @brief Returns the priority of the data point
+		auto priority() const noexcept -> Priority
+		{
+			return _priority;
+		}
+
+	private:
+		/// @brief The cycle budget manages the state
+		friend class CycleBudget;
+
+		/// @brief The priority
+		Priority _priority { Priority::Normal };
+		/// @brief The number of consecutive cycles the data point was deferred
+		std::uint32_t _deferredCycles { 0 };
+	};
+
+	/// @brief Parses a priority class from its configuration name
+	/// @return The priority, or std::nullopt if the name is unknown
+	static auto parsePriority(std::string_view name) noexcept -> std::optional<Priority>;
+
+	/// @brief Sets the budget
+	auto setBudget(std::chrono::nanoseconds budget) noexcept -> void
+	{
+		_budget = budget;
+	}
+
+	/// @brief Returns whether a budget was set
+	auto enabled() const noexcept -> bool
+	{
+		return _budget != std::chrono::nanoseconds::max();
+	}
+
+	/// @brief Decides whether a data point should be read in the current cycle
+	/// @param point The load shedding state of the data point. This must only be used by one thread at a time.
+	/// @param scheduledTime The scheduled time of the cycle
+	/// @return Whether the data point should be read. If not, the read should be skipped and the data marked as stale.
+	auto admit(Point &point, std::chrono::system_clock::time_point scheduledTime) noexcept -> bool;
+
+	/// @brief Charges the time a read took to the current cycle
+	/// @param scheduledTime The scheduled time of the cycle
+	/// @param duration The time the read took
+	auto charge(std::chrono::system_clock::time_point scheduledTime, std::chrono::nanoseconds duration) noexcept -> void;
+
+	/// @brief Returns the total number of reads that were deferred
+	auto deferredReads() const noexcept -> std::uint64_t
+	{
+		return _deferredReads.load(std::memory_order_relaxed);
+	}
+
+private:
+	/// @brief The number of consecutive deferrals after which a data point is treated as one priority class higher
+	static constexpr std::uint32_t kAgingCycles = 8;
+
+	/// @brief Gets the time spent in a cycle so far, starting a new cycle if necessary
+	auto cycleCost(std::chrono::system_clock::time_point scheduledTime) noexcept -> std::chrono::nanoseconds;
+
+	/// @brief The budget, or std::chrono::nanoseconds::max() if there is none
+	std::chrono::nanoseconds _budget { std::chrono::nanoseconds::max() };
+
+	/// @brief The scheduled time of the current cycle, in system clock ticks
+	std::atomic<std::chrono::system_clock::rep> _cycle { 0 };
+	/// @brief The time spent in the current cycle so far, in nanoseconds
+	std::atomic<std::int64_t> _cost { 0 };
+	/// @brief The total number of deferred reads
+	std::atomic<std::uint64_t> _deferredReads { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
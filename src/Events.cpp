@@ -17,4 +17,10 @@ const process::Event::Role kRead { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid,
 /// @todo assign a unique UUID
 const process::Event::Role kWritten { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "written"sv };
 
+/// @todo assign a unique UUID
+const process::Event::Role kLimitViolated { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "limitViolated"sv };
+
+/// @todo assign a unique UUID
+const process::Event::Role kLimitCleared { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "limitCleared"sv };
+
 } // namespace xentara::plugins::templateDriver::events
\ No newline at end of file
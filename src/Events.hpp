@@ -12,4 +12,9 @@ extern const process::Event::Role kRead;
 /// @brief A Xentara event that is raised when a data point was written
 extern const process::Event::Role kWritten;
 
+/// @brief A Xentara event that is raised when the alarm state of a data point becomes more severe
+extern const process::Event::Role kLimitViolated;
+/// @brief A Xentara event that is raised when the alarm state of a data point becomes less severe
+extern const process::Event::Role kLimitCleared;
+
 } // namespace xentara::plugins::templateDriver::events
\ No newline at end of file
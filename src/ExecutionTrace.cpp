@@ -0,0 +1,234 @@
+// Copyright (c) embedded ocean GmbH
+#include "ExecutionTrace.hpp"
+
+#include "NoAllocationScope.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iomanip>
+#include <system_error>
+
+namespace xentara::plugins::templateDriver
+{
+
+thread_local ExecutionTrace::ThreadState ExecutionTrace::_threadState;
+
+ExecutionTrace::Ring::Ring(std::size_t capacity, std::size_t threadIndex) :
+	_capacity(capacity),
+	_threadIndex(threadIndex),
+	_timeStamps(std::make_unique<std::atomic<std::int64_t>[]>(capacity)),
+	_details(std::make_unique<std::atomic<std::uint64_t>[]>(capacity))
+{
+}
+
+auto ExecutionTrace::spanName(Span span) noexcept -> const char *
+{
+	switch (span)
+	{
+	case Span::ReadTask:
+		return "read task";
+	case Span::WriteTask:
+		return "write task";
+	case Span::DeviceRead:
+		return "device read";
+	case Span::DeviceWrite:
+		return "device write";
+	case Span::Commit:
+		return "commit";
+	default:
+		return "unknown";
+	}
+}
+
+auto ExecutionTrace::enable(const std::filesystem::path &path, std::size_t eventsPerThread, bool dumpOnOverrun) -> void
+{
+	// Only the first caller sets up the trace
+	std::scoped_lock userLock { _userMutex };
+	if (_userCount++ > 0)
+	{
+		return;
+	}
+
+	{
+		std::scoped_lock lock { _mutex };
+		_path = path;
+		_capacity = std::bit_ceil(std::max<std::size_t>(eventsPerThread, 2));
+		_rings.clear();
+	}
+
+	// Start a new generation, so that all threads create new rings of the right size
+	_generation.fetch_add(1, std::memory_order_acq_rel);
+	_dumpOnOverrun.store(dumpOnOverrun, std::memory_order_relaxed);
+
+	// Start the dump thread. The thread of an earlier generation was already stopped by disable(), but stopping it
+	// here as well makes sure we never assign over a running thread.
+	stopDumpThread();
+	_dumpRequested.store(false, std::memory_order_relaxed);
+	_dumpThread = std::jthread([](std::stop_token stopToken) { runDumpThread(stopToken); });
+
+	_enabled.store(true, std::memory_order_release);
+}
+
+auto ExecutionTrace::disable() -> void
+{
+	// Only the last caller tears down the trace
+	std::scoped_lock userLock { _userMutex };
+	if (_userCount == 0 || --_userCount > 0)
+	{
+		return;
+	}
+
+	_enabled.store(false, std::memory_order_release);
+	_dumpOnOverrun.store(false, std::memory_order_relaxed);
+
+	stopDumpThread();
+
+	// Write the final dump
+	dump();
+
+	std::scoped_lock lock { _mutex };
+	_rings.clear();
+}
+
+auto ExecutionTrace::requestDump() noexcept -> void
+{
+	// Only wake up the dump thread if no dump is pending yet
+	if (!_dumpRequested.exchange(true, std::memory_order_acq_rel))
+	{
+		_dumpRequested.notify_one();
+	}
+}
+
+auto ExecutionTrace::record(Span span, Phase phase, std::size_t pointIndex) noexcept -> void
+{
+	const auto timeStamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	// Get the ring. Creating it allocates, but only the first time a thread records an event.
+	Ring *ring = nullptr;
+	try
+	{
+		ring = &threadRing();
+	}
+	catch (...)
+	{
+		// Just drop the event if we are out of memory
+		return;
+	}
+
+	const auto head = ring->_head.load(std::memory_order_relaxed);
+	const auto slot = head & (ring->_capacity - 1);
+	ring->_timeStamps[slot].store(timeStamp, std::memory_order_relaxed);
+	ring->_details[slot].store(
+		(std::uint64_t(std::uint32_t(pointIndex)) << 32) | (std::uint64_t(span) << 8) | std::uint64_t(phase),
+		std::memory_order_relaxed);
+	ring->_head.store(head + 1, std::memory_order_release);
+}
+
+auto ExecutionTrace::threadRing() -> Ring &
+{
+	// Create a new ring if tracing was enabled again since this thread last recorded an event
+	const auto generation = _generation.load(std::memory_order_acquire);
+	if (_threadState._generation != generation) [[unlikely]]
+	{
+		// This only happens once per thread, so it is exempt from the allocation checks of the cyclic path
+		const NoAllocationScope::Exemption allocationExemption;
+
+		std::scoped_lock lock { _mutex };
+		auto ring = std::make_shared<Ring>(_capacity, _rings.size());
+		_rings.push_back(ring);
+		_threadState._ring = std::move(ring);
+		_threadState._generation = generation;
+	}
+
+	return *_threadState._ring;
+}
+
+auto ExecutionTrace::dump() -> void
+{
+	// Take a copy of the ring list, so we don't block threads creating their rings while we write the file
+	std::filesystem::path path;
+	std::vector<std::shared_ptr<Ring>> rings;
+	{
+		std::scoped_lock lock { _mutex };
+		path = _path;
+		rings = _rings;
+	}
+
+	// Write to a temporary file first, so that a trace viewer never sees a half written file
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+	{
+		std::ofstream stream(temporaryPath, std::ios::trunc);
+		if (!stream)
+		{
+			return;
+		}
+
+		stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		auto first = true;
+		for (const auto &ring : rings)
+		{
+			// Read the events that are still in the ring
+			const auto head = ring->_head.load(std::memory_order_acquire);
+			const auto count = std::min<std::uint64_t>(head, ring->_capacity);
+			for (auto index = head - count; index < head; ++index)
+			{
+				const auto slot = index & (ring->_capacity - 1);
+				const auto timeStamp = ring->_timeStamps[slot].load(std::memory_order_relaxed);
+				const auto details = ring->_details[slot].load(std::memory_order_relaxed);
+
+				// Write the event. Time stamps are in microseconds, with nanosecond precision.
+				stream << (first ? "\n" : ",\n")
+					<< "{\"name\":\"" << spanName(Span((details >> 8) & 0xff))
+					<< "\",\"ph\":\"" << (Phase(details & 0xff) == Phase::Begin ? 'B' : 'E')
+					<< "\",\"ts\":" << timeStamp / 1000 << '.' << std::setfill('0') << std::setw(3) << timeStamp % 1000
+					<< ",\"pid\":0,\"tid\":" << ring->_threadIndex
+					<< ",\"args\":{\"point\":" << (details >> 32) << "}}";
+				first = false;
+			}
+		}
+		stream << "\n]}\n";
+
+		if (!stream)
+		{
+			return;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+}
+
+auto ExecutionTrace::stopDumpThread() -> void
+{
+	if (!_dumpThread.joinable())
+	{
+		return;
+	}
+
+	// The thread waits on the request flag, and requesting a stop does not wake it up, so we need to wake it up ourselves
+	_dumpThread.request_stop();
+	_dumpRequested.store(true, std::memory_order_release);
+	_dumpRequested.notify_all();
+	_dumpThread.join();
+}
+
+auto ExecutionTrace::runDumpThread(std::stop_token stopToken) -> void
+{
+	while (!stopToken.stop_requested())
+	{
+		// Wait for a request
+		_dumpRequested.wait(false, std::memory_order_acquire);
+		if (stopToken.stop_requested())
+		{
+			return;
+		}
+
+		_dumpRequested.store(false, std::memory_order_release);
+		dump();
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,205 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A process-wide execution trace for diagnosing cycle time spikes.
+///
+/// When enabled, each thread records begin and end events for the traced code spans into its own lock-free ring
+/// buffer, with nanosecond time stamps. The rings can be dumped to a file in the Chrome trace event JSON format, which
+/// can be loaded into chrome://tracing or the Perfetto UI.
+///
+/// When disabled, tracing a span costs a single relaxed load and a predictable branch.
+///
+/// Dumps are written by a background thread, so that requesting a dump from a cyclic task never performs file I/O.
+class ExecutionTrace final
+{
+public:
+	/// @brief The kinds of code spans that are traced
+	enum class Span : std::uint8_t
+	{
+		/// @brief The execution of a "read" task
+		ReadTask,
+		/// @brief The execution of a "write" task
+		WriteTask,
+		/// @brief A read transaction with the device
+		DeviceRead,
+		/// @brief A write transaction with the device
+		DeviceWrite,
+		/// @brief A commit of a data block, including raising its events
+		Commit
+	};
+
+	/// @brief Traces a span of code for the lifetime of the object
+	class Scope final
+	{
+	public:
+		/// @brief Records the beginning of a span, if tracing is enabled
+		/// @param span The kind of span
+		/// @param pointIndex The index of the data point the span belongs to
+		Scope(Span span, std::size_t pointIndex) noexcept : _span(span), _pointIndex(pointIndex), _active(enabled())
+		{
+			if (_active) [[unlikely]]
+			{
+				record(_span, Phase::Begin, _pointIndex);
+			}
+		}
+
+		/// @brief Records the end of the span, if its beginning was recorded
+		~Scope()
+		{
+			if (_active) [[unlikely]]
+			{
+				record(_span, Phase::End, _pointIndex);
+			}
+		}
+
+		/// @brief Deleted copy constructor
+		Scope(const Scope &) = delete;
+		/// @brief Deleted assignment operator
+		auto operator=(const Scope &) -> Scope & = delete;
+
+	private:
+		/// @brief The kind of span
+		Span _span;
+		/// @brief The index of the data point
+		std::size_t _pointIndex;
+		/// @brief Whether the beginning was recorded
+		bool _active;
+	};
+
+	/// @brief Returns whether tracing is enabled
+	static auto enabled() noexcept -> bool
+	{
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	/// @brief Enables tracing
+	///
+	/// The trace is shared by all I/O components that enable it, and stays enabled until all of them have called
+	/// disable(). Only the first call sets up the trace, so the parameters of later calls are ignored.
+	/// @param path The file the trace is dumped to
+	/// @param eventsPerThread The number of events each thread keeps. This is rounded up to the next power of two.
+	/// @param dumpOnOverrun Whether to dump the trace whenever a task overruns its cycle
+	static auto enable(const std::filesystem::path &path, std::size_t eventsPerThread, bool dumpOnOverrun) -> void;
+
+	/// @brief Disables tracing, and writes a final dump, once all the callers of enable() have called this function
+	static auto disable() -> void;
+
+	/// @brief Requests a dump of the trace.
+	///
+	/// The dump is written asynchronously by a background thread. Requests made while a dump is already pending
+	/// are merged. This function is lock-free, and can be called from cyclic tasks, e.g. when an overrun was detected.
+	static auto requestDump() noexcept -> void;
+
+	/// @brief Notifies the trace that a task overran its cycle.
+	///
+	/// This requests a dump if tracing is enabled, and dumping on overruns was requested.
+	static auto overrunDetected() noexcept -> void
+	{
+		if (_dumpOnOverrun.load(std::memory_order_relaxed)) [[unlikely]]
+		{
+			requestDump();
+		}
+	}
+
+private:
+	/// @brief Whether an event marks the beginning or the end of a span
+	enum class Phase : std::uint8_t
+	{
+		/// @brief The beginning of a span
+		Begin,
+		/// @brief The end of a span
+		End
+	};
+
+	/// @brief The ring buffer of a single thread.
+	///
+	/// The events are stored using atomics with relaxed ordering, so that dumping while the thread is recording
+	/// does not invoke undefined behaviour. Events that are overwritten during a dump may appear out of order.
+	struct Ring final
+	{
+		/// @brief Creates a ring
+		Ring(std::size_t capacity, std::size_t threadIndex);
+
+		/// @brief The number of events. This is always a power of two.
+		std::size_t _capacity;
+		/// @brief The index of the thread, used as the thread ID in the dump
+		std::size_t _threadIndex;
+		/// @brief The time stamps of the events, in steady clock nanoseconds
+		std::unique_ptr<std::atomic<std::int64_t>[]> _timeStamps;
+		/// @brief The rest of the events, packed as point index (upper 32 bits), span (bits 8-15) and phase (bits 0-7)
+		std::unique_ptr<std::atomic<std::uint64_t>[]> _details;
+		/// @brief The total number of events recorded
+		std::atomic<std::uint64_t> _head { 0 };
+	};
+
+	/// @brief The ring of a thread
+	struct ThreadState final
+	{
+		/// @brief The ring, or nullptr if the thread has not recorded any events yet
+		std::shared_ptr<Ring> _ring;
+		/// @brief The generation the ring belongs to
+		std::uint64_t _generation { 0 };
+	};
+
+	/// @brief Gets the name of a span for the trace file
+	static auto spanName(Span span) noexcept -> const char *;
+
+	/// @brief Records an event
+	static auto record(Span span, Phase phase, std::size_t pointIndex) noexcept -> void;
+
+	/// @brief Gets the ring of the current thread, creating it if necessary
+	static auto threadRing() -> Ring &;
+
+	/// @brief Writes all rings to the trace file
+	static auto dump() -> void;
+
+	/// @brief The main function of the dump thread
+	static auto runDumpThread(std::stop_token stopToken) -> void;
+
+	/// @brief Stops the dump thread, if it is running, and waits for it to finish
+	static auto stopDumpThread() -> void;
+
+	/// @brief Whether tracing is enabled
+	static inline std::atomic<bool> _enabled { false };
+	/// @brief The generation of the rings. Increments every time tracing is enabled, so threads create new rings.
+	static inline std::atomic<std::uint64_t> _generation { 0 };
+	/// @brief Whether a dump was requested
+	static inline std::atomic<bool> _dumpRequested { false };
+	/// @brief Whether to dump the trace on overruns
+	static inline std::atomic<bool> _dumpOnOverrun { false };
+
+	/// @brief The mutex serializing enable() and disable()
+	static inline std::mutex _userMutex;
+	/// @brief The number of callers of enable() that have not called disable() yet
+	static inline std::size_t _userCount { 0 };
+
+	/// @brief The mutex protecting the members below
+	static inline std::mutex _mutex;
+	/// @brief The file to dump to
+	static inline std::filesystem::path _path;
+	/// @brief The number of events per thread
+	static inline std::size_t _capacity { 0 };
+	/// @brief The rings of all threads of the current generation
+	static inline std::vector<std::shared_ptr<Ring>> _rings;
+	/// @brief The thread that writes the dumps
+	static inline std::jthread _dumpThread;
+
+	/// @brief The ring of the current thread
+	static thread_local ThreadState _threadState;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
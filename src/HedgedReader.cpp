@@ -0,0 +1,401 @@
+// Copyright (c) embedded ocean GmbH
+#include "HedgedReader.hpp"
+
+#include "Attributes.hpp"
+#include "CustomError.hpp"
+
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/process/EventList.hpp>
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief The number of primary responses needed before the observed latencies are used to determine the hedge delay
+	constexpr std::uint64_t kMinimumSamples = 64;
+
+	/// @brief How often the statistics are published
+	constexpr std::uint64_t kPublishInterval = 256;
+
+} // namespace
+
+auto HedgedReader::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support, if enabled
+	return enabled() && (
+		function(attributes::kHedgedReads) ||
+		function(attributes::kSecondaryWinRatio) ||
+		function(attributes::kReadLatencyP99));
+}
+
+auto HedgedReader::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	if (!enabled())
+	{
+		return std::nullopt;
+	}
+
+	// Try each readable attribute
+	if (attribute == attributes::kHedgedReads)
+	{
+		return _dataBlock.member(&State::_hedgedReads);
+	}
+	else if (attribute == attributes::kSecondaryWinRatio)
+	{
+		return _dataBlock.member(&State::_secondaryWinRatio);
+	}
+	else if (attribute == attributes::kReadLatencyP99)
+	{
+		return _dataBlock.member(&State::_readLatencyP99);
+	}
+
+	return std::nullopt;
+}
+
+auto HedgedReader::realize() -> void
+{
+	// Create the data block
+	_dataBlock.create(memory::memoryResources::data());
+}
+
+auto HedgedReader::start(const std::string &primaryAddress, std::size_t window, std::chrono::nanoseconds timeout, const ReconnectBackoff &backoff,
+	Completion completion, ConnectionHandler connectionHandler) -> void
+{
+	_timeout = timeout;
+	_completion = std::move(completion);
+	_connectionHandler = std::move(connectionHandler);
+	_requests.assign(window, {});
+	for (auto &owners : _owners)
+	{
+		owners.assign(window, 0);
+	}
+
+	// Connect both paths. The clients connect in the background, and reads on a path that is not connected fail right away,
+	// so they are sent on the other path instead.
+	const std::string *addresses[] { &primaryAddress, &_secondaryAddress };
+	for (auto path : { Path::Primary, Path::Secondary })
+	{
+		auto &client = _clients[std::size_t(path)];
+		client = std::make_unique<PipelinedClient>(*addresses[std::size_t(path)], window, timeout, backoff,
+			[this, path](std::uint32_t transactionId, std::size_t, std::chrono::system_clock::time_point,
+				const utils::eh::expected<double, std::error_code> &valueOrError) {
+				complete(path, transactionId, valueOrError);
+			},
+			[this, path](std::error_code error) { connectionChanged(path, error); });
+		client->start();
+	}
+
+	// Start the thread that sends the reads on the secondary path
+	_thread = std::jthread([this](std::stop_token stopToken) { run(stopToken); });
+}
+
+auto HedgedReader::stop() -> void
+{
+	// Stop the thread first, so that no new requests are sent
+	_thread = {};
+
+	// Stop both paths before destroying either client. The receiver thread of one path may still complete a request,
+	// and cancel it on the other path, until both threads have been joined.
+	for (auto &client : _clients)
+	{
+		if (client)
+		{
+			client->stop();
+		}
+	}
+	for (auto &client : _clients)
+	{
+		client.reset();
+	}
+	_connected[0] = _connected[1] = false;
+
+	publish();
+}
+
+auto HedgedReader::read(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp) -> void
+{
+	std::unique_lock lock { _mutex };
+
+	// If the maximum number of reads is already in flight, fail right away instead of stalling the calling task
+	if (_inFlight >= _requests.size())
+	{
+		lock.unlock();
+		_completion(pointIndex, timeStamp, utils::eh::unexpected(CustomError::Busy));
+		return;
+	}
+	const auto requestIndex = std::size_t(std::ranges::find(_requests, false, &Request::_active) - _requests.begin());
+	auto &request = _requests[requestIndex];
+	++_inFlight;
+
+	const auto now = std::chrono::steady_clock::now();
+	request = { ._active = true, ._pointIndex = pointIndex, ._timeStamp = timeStamp, ._startTime = now,
+		._hedgeTime = std::nullopt, ._transactionIds = {}, ._error = {} };
+
+	// Send the read on the primary path. This is done while holding the lock, so that the response cannot be handled
+	// before the transaction ID has been recorded.
+	const auto transactionId = _clients[std::size_t(Path::Primary)]->read(pointIndex, timeStamp);
+	if (transactionId)
+	{
+		request._transactionIds[std::size_t(Path::Primary)] = *transactionId;
+		_owners[std::size_t(Path::Primary)][*transactionId % _requests.size()] = requestIndex;
+		request._hedgeTime = now + hedgeDelay();
+	}
+	// If the primary path failed, send the read on the secondary path right away
+	else
+	{
+		request._error = transactionId.error();
+		request._hedgeTime = now;
+	}
+
+	// Wake up the thread that sends the reads on the secondary path
+	_scheduleChanged = true;
+	_condition.notify_all();
+}
+
+auto HedgedReader::connectionChanged(Path path, std::error_code error) -> void
+{
+	// Only report a change if the device became reachable or unreachable as a whole
+	bool changed = false;
+	{
+		std::scoped_lock lock { _mutex };
+		const auto wasConnected = _connected[0] || _connected[1];
+		_connected[std::size_t(path)] = !error;
+		changed = wasConnected != (_connected[0] || _connected[1]);
+	}
+
+	if (changed && _connectionHandler)
+	{
+		_connectionHandler(error);
+	}
+}
+
+auto HedgedReader::complete(Path path, std::uint32_t transactionId, const utils::eh::expected<double, std::error_code> &valueOrError) -> void
+{
+	std::unique_lock lock { _mutex };
+
+	// Find the request. Responses to requests that have already been decided are ignored.
+	const auto requestIndex = findRequest(path, transactionId);
+	if (!requestIndex)
+	{
+		return;
+	}
+	auto &request = _requests[*requestIndex];
+	request._transactionIds[std::size_t(path)].reset();
+
+	const auto otherPath = path == Path::Primary ? Path::Secondary : Path::Primary;
+	auto &otherTransactionId = request._transactionIds[std::size_t(otherPath)];
+	const auto now = std::chrono::steady_clock::now();
+
+	// The first successful response wins
+	if (valueOrError)
+	{
+		// Record the latency of the primary path. If the secondary path won while the primary request was still in
+		// flight, the primary latency is at least the time elapsed so far. Recording that lower bound keeps slow primary
+		// responses in the statistics; leaving them out would make the hedge delay shrink, and the share of hedged
+		// reads grow, with every read that is hedged.
+		if (path == Path::Primary || otherTransactionId)
+		{
+			_primaryLatencies.record(now - request._startTime);
+		}
+		_latencies.record(now - request._startTime);
+
+		// Cancel the request on the other path
+		if (otherTransactionId)
+		{
+			_clients[std::size_t(otherPath)]->cancel(*otherTransactionId);
+		}
+
+		// Complete the read outside the lock
+		const auto pointIndex = request._pointIndex;
+		const auto timeStamp = request._timeStamp;
+		const auto needsPublishing = finish(*requestIndex, path);
+		lock.unlock();
+		_completion(pointIndex, timeStamp, valueOrError);
+		if (needsPublishing)
+		{
+			publish();
+		}
+		return;
+	}
+
+	request._error = valueOrError.error();
+
+	// If the request is still in flight on the other path, wait for that
+	if (otherTransactionId)
+	{
+		return;
+	}
+
+	// If the read was not sent on the secondary path yet, send it right away
+	if (request._hedgeTime)
+	{
+		request._hedgeTime = now;
+		_scheduleChanged = true;
+		_condition.notify_all();
+		return;
+	}
+
+	// Both paths failed
+	const auto pointIndex = request._pointIndex;
+	const auto timeStamp = request._timeStamp;
+	const auto error = request._error;
+	const auto needsPublishing = finish(*requestIndex, std::nullopt);
+	lock.unlock();
+	_completion(pointIndex, timeStamp, utils::eh::unexpected(error));
+	if (needsPublishing)
+	{
+		publish();
+	}
+}
+
+auto HedgedReader::findRequest(Path path, std::uint32_t transactionId) const noexcept -> std::optional<std::size_t>
+{
+	const auto isOwner = [&](const Request &request) {
+		return request._active && request._transactionIds[std::size_t(path)] == transactionId;
+	};
+
+	// The request is usually the last one sent using the slot of the transaction
+	const auto owner = _owners[std::size_t(path)][transactionId % _requests.size()];
+	if (isOwner(_requests[owner]))
+	{
+		return owner;
+	}
+
+	// The client frees the slot before it reports the completion, so the slot may already have been reused for another
+	// request in the meantime. Search for the request in that case.
+	const auto request = std::ranges::find_if(_requests, isOwner);
+	if (request == _requests.end())
+	{
+		return std::nullopt;
+	}
+	return std::size_t(request - _requests.begin());
+}
+
+auto HedgedReader::run(std::stop_token stopToken) -> void
+{
+	std::unique_lock lock { _mutex };
+
+	while (!stopToken.stop_requested())
+	{
+		// Find the read that is due next on the secondary path
+		std::optional<std::size_t> nextIndex;
+		for (std::size_t index = 0; index < _requests.size(); ++index)
+		{
+			const auto &request = _requests[index];
+			if (request._active && request._hedgeTime && (!nextIndex || *request._hedgeTime < *_requests[*nextIndex]._hedgeTime))
+			{
+				nextIndex = index;
+			}
+		}
+
+		// Wait until the read is due, or until the schedule changes
+		const auto wakeUp = [this]() { return std::exchange(_scheduleChanged, false); };
+		if (!nextIndex)
+		{
+			_condition.wait(lock, stopToken, wakeUp);
+			continue;
+		}
+		if (*_requests[*nextIndex]._hedgeTime > std::chrono::steady_clock::now())
+		{
+			_condition.wait_until(lock, stopToken, *_requests[*nextIndex]._hedgeTime, wakeUp);
+			continue;
+		}
+
+		hedge(lock, *nextIndex);
+	}
+}
+
+auto HedgedReader::hedge(std::unique_lock<std::mutex> &lock, std::size_t requestIndex) -> void
+{
+	auto &request = _requests[requestIndex];
+	request._hedgeTime.reset();
+	++_hedgedReads;
+
+	// Send the read on the secondary path
+	const auto transactionId = _clients[std::size_t(Path::Secondary)]->read(request._pointIndex, request._timeStamp);
+	if (transactionId)
+	{
+		request._transactionIds[std::size_t(Path::Secondary)] = *transactionId;
+		_owners[std::size_t(Path::Secondary)][*transactionId % _requests.size()] = requestIndex;
+		return;
+	}
+	request._error = transactionId.error();
+
+	// If the request is still in flight on the primary path, wait for that
+	if (request._transactionIds[std::size_t(Path::Primary)])
+	{
+		return;
+	}
+
+	// Both paths failed
+	const auto pointIndex = request._pointIndex;
+	const auto timeStamp = request._timeStamp;
+	const auto error = request._error;
+	const auto needsPublishing = finish(requestIndex, std::nullopt);
+	lock.unlock();
+	_completion(pointIndex, timeStamp, utils::eh::unexpected(error));
+	if (needsPublishing)
+	{
+		publish();
+	}
+	lock.lock();
+}
+
+auto HedgedReader::hedgeDelay() const noexcept -> std::chrono::nanoseconds
+{
+	// Until we have observed enough latencies, only hedge reads that take half the timeout
+	if (_primaryLatencies.count() < kMinimumSamples)
+	{
+		return _timeout / 2;
+	}
+
+	return _primaryLatencies.percentile(_hedgePercentile);
+}
+
+auto HedgedReader::finish(std::size_t requestIndex, std::optional<Path> winner) -> bool
+{
+	_requests[requestIndex] = {};
+	--_inFlight;
+
+	if (winner)
+	{
+		++_wins[std::size_t(*winner)];
+	}
+
+	// Publish the statistics every so often
+	if (++_unpublishedReads < kPublishInterval)
+	{
+		return false;
+	}
+	_unpublishedReads = 0;
+	return true;
+}
+
+auto HedgedReader::publish() -> void
+{
+	// Get the statistics
+	State statistics;
+	{
+		std::scoped_lock lock { _mutex };
+		const auto wins = _wins[0] + _wins[1];
+		statistics._hedgedReads = _hedgedReads;
+		statistics._secondaryWinRatio = wins ? double(_wins[std::size_t(Path::Secondary)]) / double(wins) : 0.0;
+		statistics._readLatencyP99 = std::uint64_t(_latencies.percentile(0.99).count());
+	}
+
+	std::scoped_lock lock { _publishMutex };
+
+	// Make a write sentinel
+	memory::WriteSentinel sentinel { _dataBlock };
+	*sentinel = statistics;
+
+	// Commit the data without raising any events
+	sentinel.commit(std::chrono::system_clock::now(), process::StaticEventList<1> {});
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
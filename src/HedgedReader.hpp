@@ -0,0 +1,221 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include "PipelinedClient.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/ObjectBlock.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Reads data points over two redundant paths to the same device, to cut the tail latency.
+///
+/// Each read is sent on the primary path first. If no response has arrived after a configurable percentile of the
+/// latencies observed on the primary path, the read is sent on the secondary path as well. The first successful
+/// response wins, and the request on the other path is cancelled. If the primary path fails outright, the read is sent
+/// on the secondary path right away, which also covers the time the primary path is reconnecting.
+///
+/// The number of reads that were sent on both paths, the share of reads won by the secondary path, and the 99th
+/// percentile of the read latency are published as attributes.
+class HedgedReader final
+{
+public:
+	/// @brief The function called when a read completes
+	/// @todo use the correct value type
+	using Completion = std::function<void(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<double, std::error_code> &valueOrError)>;
+
+	/// @brief The function called when the first path connects, or when the last connected path loses its connection
+	using ConnectionHandler = PipelinedClient::ConnectionHandler;
+
+	/// @brief Sets the address of the secondary path
+	auto setSecondaryAddress(std::string address) -> void
+	{
+		_secondaryAddress = std::move(address);
+	}
+
+	/// @brief Sets the percentile of the primary latency after which a read is sent on the secondary path as well
+	/// @param fraction The percentile, as fraction between 0 and 1
+	auto setHedgePercentile(double fraction) noexcept -> void
+	{
+		_hedgePercentile = fraction;
+	}
+
+	/// @brief Checks whether hedged reads are enabled, which is the case if a secondary path was configured
+	auto enabled() const noexcept -> bool
+	{
+		return !_secondaryAddress.empty();
+	}
+
+	/// @brief Iterates over all the attributes, if hedged reads are enabled
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Creates a read-handle for an attribute, if hedged reads are enabled
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown
+	auto makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>;
+
+	/// @brief Realizes the object
+	auto realize() -> void;
+
+	/// @brief Starts connecting both paths in the background, and sending requests on the secondary path when they are due
+	/// @param primaryAddress The address of the primary path
+	/// @param window The maximum number of reads in flight at the same time
+	/// @param timeout The time after which a request on either path fails
+	/// @param backoff Determines the delays between attempts to connect either path
+	/// @param completion The function called when a read completes
+	/// @param connectionHandler The function called when the first path connects, or when the last connected path
+	/// loses its connection
+	auto start(const std::string &primaryAddress, std::size_t window, std::chrono::nanoseconds timeout, const ReconnectBackoff &backoff,
+		Completion completion, ConnectionHandler connectionHandler) -> void;
+
+	/// @brief Stops sending requests, and disconnects both paths
+	auto stop() -> void;
+
+	/// @brief Sends a read request
+	///
+	/// This function never blocks. If the maximum number of reads is already in flight, the read fails with
+	/// CustomError::Busy. The result, including any error, is always reported using the completion function.
+	/// @param pointIndex The index of the data point to read
+	/// @param timeStamp The time stamp to pass to the completion function
+	auto read(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp) -> void;
+
+private:
+	/// @brief The paths to the device
+	enum class Path
+	{
+		/// @brief The primary path
+		Primary,
+		/// @brief The secondary path
+		Secondary
+	};
+
+	/// @brief A read in flight
+	struct Request final
+	{
+		/// @brief Whether the entry is in use
+		bool _active { false };
+		/// @brief The index of the data point
+		std::size_t _pointIndex { 0 };
+		/// @brief The time stamp to pass to the completion function
+		std::chrono::system_clock::time_point _timeStamp;
+		/// @brief The time the read was sent on the primary path
+		std::chrono::steady_clock::time_point _startTime;
+		/// @brief The time the read is due to be sent on the secondary path, or std::nullopt if it was already sent
+		std::optional<std::chrono::steady_clock::time_point> _hedgeTime;
+		/// @brief The transaction IDs of the requests in flight on each path
+		std::optional<std::uint32_t> _transactionIds[2];
+		/// @brief The last error received on either path
+		std::error_code _error;
+	};
+
+	/// @brief This structure is used to represent the state inside the memory block
+	struct State final
+	{
+		/// @brief The number of reads that were sent on both paths
+		std::uint64_t _hedgedReads { 0 };
+		/// @brief The share of successful reads that were won by the secondary path
+		double _secondaryWinRatio { 0 };
+		/// @brief The 99th percentile of the read latency, in nanoseconds
+		std::uint64_t _readLatencyP99 { 0 };
+	};
+
+	/// @brief Handles a change in the connection of one of the paths
+	auto connectionChanged(Path path, std::error_code error) -> void;
+
+	/// @brief Handles the completion of a request on one of the paths
+	auto complete(Path path, std::uint32_t transactionId, const utils::eh::expected<double, std::error_code> &valueOrError) -> void;
+
+	/// @brief Finds the request a transaction on one of the paths belongs to. The mutex must be held.
+	/// @return The index of the request, or std::nullopt if the transaction is no longer in flight
+	auto findRequest(Path path, std::uint32_t transactionId) const noexcept -> std::optional<std::size_t>;
+
+	/// @brief The thread function that sends the reads on the secondary path when they are due
+	auto run(std::stop_token stopToken) -> void;
+
+	/// @brief Sends a read on the secondary path, or completes it with an error if that is not possible
+	/// @note The lock must be held. It is released temporarily if the read fails.
+	auto hedge(std::unique_lock<std::mutex> &lock, std::size_t requestIndex) -> void;
+
+	/// @brief Returns the time after which a read should be sent on the secondary path as well
+	auto hedgeDelay() const noexcept -> std::chrono::nanoseconds;
+
+	/// @brief Frees a request and updates the statistics. The mutex must be held.
+	/// @return Whether the statistics should be published
+	auto finish(std::size_t requestIndex, std::optional<Path> winner) -> bool;
+
+	/// @brief Publishes the current statistics
+	auto publish() -> void;
+
+	/// @brief The address of the secondary path
+	std::string _secondaryAddress;
+	/// @brief The percentile of the primary latency after which a read is sent on the secondary path
+	double _hedgePercentile { 0.95 };
+	/// @brief The request timeout
+	std::chrono::nanoseconds _timeout { 0 };
+	/// @brief The completion function
+	Completion _completion;
+	/// @brief The connection handler
+	ConnectionHandler _connectionHandler;
+
+	/// @brief The clients for both paths, indexed by Path
+	std::unique_ptr<PipelinedClient> _clients[2];
+	/// @brief Whether each path is connected
+	bool _connected[2] { false, false };
+
+	/// @brief The reads in flight
+	std::vector<Request> _requests;
+	/// @brief The number of reads in flight
+	std::size_t _inFlight { 0 };
+	/// @brief The index of the request last sent using each slot of the client of each path, indexed by the transaction
+	/// ID modulo the window size
+	std::vector<std::size_t> _owners[2];
+
+	/// @brief The latencies of the successful responses on the primary path, which determine the hedge delay. Primary
+	/// requests that were cancelled because the secondary path won are recorded with the time they had been in flight.
+	LatencyHistogram _primaryLatencies;
+	/// @brief The latencies of all successful reads
+	LatencyHistogram _latencies;
+	/// @brief The number of reads that were sent on both paths
+	std::uint64_t _hedgedReads { 0 };
+	/// @brief The number of successful reads won by each path
+	std::uint64_t _wins[2] { 0, 0 };
+
+	/// @brief A mutex protecting the requests and the statistics
+	std::mutex _mutex;
+	/// @brief Signaled when the time a read is due on the secondary path changed
+	std::condition_variable_any _condition;
+	/// @brief Set when the time a read is due on the secondary path changed, to wake up the thread
+	bool _scheduleChanged { false };
+	/// @brief The number of reads completed since the statistics were last published
+	std::uint64_t _unpublishedReads { 0 };
+	/// @brief The thread that sends the reads on the secondary path
+	std::jthread _thread;
+
+	/// @brief A mutex serializing commits to the data block, which may happen from the receiver threads of both paths
+	std::mutex _publishMutex;
+	/// @brief The data block that contains the state
+	memory::ObjectBlock<State> _dataBlock;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Copyright (c) embedded ocean GmbH
+#include "IoRecord.hpp"
+
+#include "CustomError.hpp"
+
+namespace xentara::plugins::templateDriver
+{
+
+auto IoRecord::setError(const std::error_code &error) noexcept -> void
+{
+	_errorCode = error.value();
+
+	// Determine the category
+	if (!error)
+	{
+		_errorCategory = ErrorCategory::None;
+	}
+	else if (error.category() == customErrorCategory())
+	{
+		_errorCategory = ErrorCategory::Custom;
+	}
+	else if (error.category() == std::system_category())
+	{
+		_errorCategory = ErrorCategory::System;
+	}
+	else if (error.category() == std::generic_category())
+	{
+		_errorCategory = ErrorCategory::Generic;
+	}
+	else
+	{
+		_errorCategory = ErrorCategory::Other;
+	}
+}
+
+auto IoRecord::error() const noexcept -> std::error_code
+{
+	switch (_errorCategory)
+	{
+	case ErrorCategory::None:
+		return {};
+
+	case ErrorCategory::Custom:
+		return { _errorCode, customErrorCategory() };
+
+	case ErrorCategory::System:
+		return { _errorCode, std::system_category() };
+
+	case ErrorCategory::Generic:
+		return { _errorCode, std::generic_category() };
+
+	case ErrorCategory::Other:
+	default:
+		return CustomError::UnknownError;
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,68 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A single record in an I/O recording file.
+///
+/// A recording file consists of nothing but a sequence of these records, in the order in which the I/O transactions
+/// completed. The records use the native byte order and floating point representation.
+struct IoRecord final
+{
+	/// @brief The kind of transaction
+	enum class Kind : std::uint8_t
+	{
+		/// @brief A value was read from the I/O component
+		Read,
+		/// @brief A value was written to the I/O component
+		Write
+	};
+
+	/// @brief The error category of a recorded error
+	enum class ErrorCategory : std::uint8_t
+	{
+		/// @brief No error occurred
+		None,
+		/// @brief A @ref CustomError
+		Custom,
+		/// @brief An error from std::system_category()
+		System,
+		/// @brief An error from std::generic_category()
+		Generic,
+		/// @brief An error from some other category. These cannot be reproduced exactly.
+		Other
+	};
+
+	/// @brief Encodes an error code into the error fields of the record
+	auto setError(const std::error_code &error) noexcept -> void;
+
+	/// @brief Decodes the error code from the error fields of the record
+	auto error() const noexcept -> std::error_code;
+
+	/// @brief The start time of the transaction, in nanoseconds since the recording started
+	std::int64_t _offset { 0 };
+	/// @brief The index of the data point within the I/O component
+	std::uint32_t _pointIndex { 0 };
+	/// @brief The kind of transaction
+	Kind _kind { Kind::Read };
+	/// @brief The category of the error code
+	ErrorCategory _errorCategory { ErrorCategory::None };
+	/// @brief Reserved for future use, always 0
+	std::uint16_t _reserved { 0 };
+	/// @brief The error code value
+	std::int32_t _errorCode { 0 };
+	/// @brief The duration of the transaction in nanoseconds, saturated to the range of the type
+	std::uint32_t _duration { 0 };
+	/// @brief The value read or written
+	/// @todo use the correct value type
+	double _value { 0 };
+};
+
+static_assert(std::is_trivially_copyable_v<IoRecord> && sizeof(IoRecord) == 32);
+
+} // namespace xentara::plugins::templateDriver
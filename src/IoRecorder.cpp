@@ -0,0 +1,68 @@
+// Copyright (c) embedded ocean GmbH
+#include "IoRecorder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+
+namespace xentara::plugins::templateDriver
+{
+
+IoRecorder::IoRecorder(const std::filesystem::path &path) :
+	_stream(path, std::ios::binary | std::ios::trunc)
+{
+	if (!_stream)
+	{
+		throw std::system_error(errno, std::generic_category(), "could not open I/O recording file");
+	}
+}
+
+auto IoRecorder::recordRead(std::size_t pointIndex,
+	std::chrono::steady_clock::time_point startTime,
+	const utils::eh::expected<double, std::error_code> &valueOrError) -> void
+{
+	IoRecord record;
+	record._kind = IoRecord::Kind::Read;
+	if (valueOrError)
+	{
+		record._value = *valueOrError;
+	}
+	else
+	{
+		record.setError(valueOrError.error());
+	}
+
+	append(record, pointIndex, startTime);
+}
+
+auto IoRecorder::recordWrite(
+	std::size_t pointIndex, std::chrono::steady_clock::time_point startTime, double value, std::error_code error) -> void
+{
+	IoRecord record;
+	record._kind = IoRecord::Kind::Write;
+	record._value = value;
+	record.setError(error);
+
+	append(record, pointIndex, startTime);
+}
+
+auto IoRecorder::flush() -> void
+{
+	std::scoped_lock lock { _mutex };
+	_stream.flush();
+}
+
+auto IoRecorder::append(IoRecord &record, std::size_t pointIndex, std::chrono::steady_clock::time_point startTime) -> void
+{
+	const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+
+	record._offset = std::chrono::duration_cast<std::chrono::nanoseconds>(startTime - _startTime).count();
+	record._pointIndex = std::uint32_t(pointIndex);
+	record._duration = std::uint32_t(std::clamp<std::chrono::nanoseconds::rep>(
+		duration.count(), 0, std::numeric_limits<std::uint32_t>::max()));
+
+	std::scoped_lock lock { _mutex };
+	_stream.write(reinterpret_cast<const char *>(&record), sizeof(record));
+}
+
+} // namespace xentara::plugins::templateDriver
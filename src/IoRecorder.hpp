@@ -0,0 +1,62 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "IoRecord.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Records all I/O transactions of an I/O component into an append-only binary file.
+///
+/// The file can later be fed back through the data points using @ref IoReplayer. Each transaction is stored as a single
+/// fixed-size @ref IoRecord. Records are buffered, and written to the file in large blocks.
+class IoRecorder final
+{
+public:
+	/// @brief Opens the recording file
+	/// @param path The path of the file. If the file exists, it is overwritten.
+	/// @throw std::system_error The file could not be opened
+	explicit IoRecorder(const std::filesystem::path &path);
+
+	/// @brief Records a read transaction
+	/// @param pointIndex The index of the data point within the I/O component
+	/// @param startTime The time the transaction was started. The transaction is assumed to have completed just now.
+	/// @param valueOrError The value that was read, or the error that occurred
+	auto recordRead(std::size_t pointIndex,
+		std::chrono::steady_clock::time_point startTime,
+		const utils::eh::expected<double, std::error_code> &valueOrError) -> void;
+
+	/// @brief Records a write transaction
+	/// @param pointIndex The index of the data point within the I/O component
+	/// @param startTime The time the transaction was started. The transaction is assumed to have completed just now.
+	/// @param value The value that was written
+	/// @param error The error that occurred, or a default constructed std::error_code object for none
+	auto recordWrite(
+		std::size_t pointIndex, std::chrono::steady_clock::time_point startTime, double value, std::error_code error) -> void;
+
+	/// @brief Writes all buffered records to the file
+	auto flush() -> void;
+
+private:
+	/// @brief Fills in the common fields of a record and appends it to the file
+	auto append(IoRecord &record, std::size_t pointIndex, std::chrono::steady_clock::time_point startTime) -> void;
+
+	/// @brief The time the recording started
+	std::chrono::steady_clock::time_point _startTime { std::chrono::steady_clock::now() };
+
+	/// @brief The file
+	std::ofstream _stream;
+	/// @brief A mutex protecting the file, since the tasks of different data points may run on different threads
+	std::mutex _mutex;
+};
+
+} // namespace xentara::plugins::templateDriver
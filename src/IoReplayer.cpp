@@ -0,0 +1,127 @@
+// Copyright (c) embedded ocean GmbH
+#include "IoReplayer.hpp"
+
+#include <cerrno>
+#include <fstream>
+
+namespace xentara::plugins::templateDriver
+{
+
+IoReplayer::IoReplayer(const std::filesystem::path &path, std::size_t pointCount, double speed) :
+	_reads(pointCount),
+	_writes(pointCount),
+	_speed(speed)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		throw std::system_error(errno, std::generic_category(), "could not open I/O recording file");
+	}
+
+	// Sort the records into the streams
+	IoRecord record;
+	while (stream.read(reinterpret_cast<char *>(&record), sizeof(record)))
+	{
+		if (record._pointIndex >= pointCount)
+		{
+			continue;
+		}
+
+		auto &streams = record._kind == IoRecord::Kind::Write ? _writes : _reads;
+		streams[record._pointIndex]._records.push_back(record);
+	}
+}
+
+auto IoReplayer::nextRead(std::size_t pointIndex) noexcept -> std::optional<utils::eh::expected<double, std::error_code>>
+{
+	const auto record = advance(_reads[pointIndex]);
+	if (!record)
+	{
+		return std::nullopt;
+	}
+
+	if (const auto error = record->error())
+	{
+		return utils::eh::unexpected(error);
+	}
+	return record->_value;
+}
+
+auto IoReplayer::nextSamples(std::size_t pointIndex, std::size_t sampleCount) noexcept -> std::span<const IoRecord>
+{
+	auto &stream = _reads[pointIndex];
+	const auto first = stream._next;
+
+	// In step mode, take the next records up to the end of the read
+	if (_speed <= 0)
+	{
+		auto end = first;
+		while (end < stream._records.size() && end - first < sampleCount)
+		{
+			// A failed sample ends the read
+			if (stream._records[end++].error())
+			{
+				break;
+			}
+		}
+		stream._next = end;
+		return std::span(stream._records).subspan(first, end - first);
+	}
+
+	// Skip to the last record that is due
+	if (!advance(stream))
+	{
+		return {};
+	}
+
+	// Go back to the first sample of the read. The samples of a read were recorded right after each other, so they are all
+	// due by now. Records skipped by advance() may be used, but not the error record that ended an earlier read.
+	auto begin = stream._next - 1;
+	while (begin > first && stream._next - begin < sampleCount && !stream._records[begin - 1].error())
+	{
+		--begin;
+	}
+	return std::span(stream._records).subspan(begin, stream._next - begin);
+}
+
+auto IoReplayer::nextWrite(std::size_t pointIndex) noexcept -> std::error_code
+{
+	// Writes are triggered by the user, not by the device, so they are always replayed in order, regardless of timing
+	auto &stream = _writes[pointIndex];
+	if (stream._next >= stream._records.size())
+	{
+		return {};
+	}
+	return stream._records[stream._next++].error();
+}
+
+auto IoReplayer::advance(Stream &stream) noexcept -> const IoRecord *
+{
+	// Check if there are any records left
+	if (stream._next >= stream._records.size())
+	{
+		return nullptr;
+	}
+
+	// In step mode, just return the next record
+	if (_speed <= 0)
+	{
+		return &stream._records[stream._next++];
+	}
+
+	// Determine the current position within the recording
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _startTime);
+	const auto position = std::int64_t(elapsed.count() * _speed);
+
+	// Skip to the last record that is due. If we are being called less often than during recording,
+	// intermediate results are dropped, just like they would be by a slower device.
+	const IoRecord *record = nullptr;
+	while (stream._next < stream._records.size() && stream._records[stream._next]._offset <= position)
+	{
+		record = &stream._records[stream._next++];
+	}
+
+	return record;
+}
+
+} // namespace xentara::plugins::templateDriver
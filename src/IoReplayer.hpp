@@ -0,0 +1,93 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "IoRecord.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Replays a file recorded using @ref IoRecorder in place of the real I/O component.
+///
+/// The whole file is loaded into memory up front, and split into separate streams of read and write transactions
+/// for each data point, so that replaying never performs any file I/O or allocations.
+///
+/// Read transactions are replayed according to the time at which they were recorded, scaled by a speed factor. A speed
+/// factor of 0 replays one transaction per call, regardless of timing, which is useful for benchmarks.
+class IoReplayer final
+{
+public:
+	/// @brief Loads a recording file
+	/// @param path The path of the file
+	/// @param pointCount The number of data points of the I/O component. Records for other points are ignored.
+	/// @param speed The speed factor. 1 replays at the recorded speed, 2 at twice the speed etc.
+	/// @throw std::system_error The file could not be read
+	IoReplayer(const std::filesystem::path &path, std::size_t pointCount, double speed);
+
+	/// @brief Starts the replay clock
+	auto start() noexcept -> void
+	{
+		_startTime = std::chrono::steady_clock::now();
+	}
+
+	/// @brief Gets the result of the next read transaction for a data point
+	///
+	/// This function must only be called by one thread at a time for each data point.
+	/// @param pointIndex The index of the data point
+	/// @return The value or error that was read, or std::nullopt if no transaction is due yet
+	auto nextRead(std::size_t pointIndex) noexcept -> std::optional<utils::eh::expected<double, std::error_code>>;
+
+	/// @brief Gets the records of the next read of an oversampled data point
+	///
+	/// An oversampled read is recorded as one record per sample. If a sample failed, its error record is the last record
+	/// of the read. This function returns the records of the last read that is due, or of the next read in step mode.
+	/// This function must only be called by one thread at a time for each data point.
+	/// @param pointIndex The index of the data point
+	/// @param sampleCount The number of samples per read
+	/// @return The records of the read, or an empty span if no read is due yet
+	auto nextSamples(std::size_t pointIndex, std::size_t sampleCount) noexcept -> std::span<const IoRecord>;
+
+	/// @brief Gets the result of the next write transaction for a data point
+	///
+	/// Write transactions are always replayed in order, one per call, since they are triggered by the user rather than
+	/// the device. This function must only be called by one thread at a time for each data point.
+	/// @param pointIndex The index of the data point
+	/// @return The recorded error, or a default constructed std::error_code object if the write succeeded or if
+	/// there are no more write transactions
+	auto nextWrite(std::size_t pointIndex) noexcept -> std::error_code;
+
+private:
+	/// @brief The transactions of a single kind for a single data point
+	struct Stream final
+	{
+		/// @brief The records
+		std::vector<IoRecord> _records;
+		/// @brief The index of the next record to replay
+		std::size_t _next { 0 };
+	};
+
+	/// @brief Advances a stream to the last record that is due
+	/// @return The record, or nullptr if none is due
+	auto advance(Stream &stream) noexcept -> const IoRecord *;
+
+	/// @brief The read transactions, indexed by point index
+	std::vector<Stream> _reads;
+	/// @brief The write transactions, indexed by point index
+	std::vector<Stream> _writes;
+
+	/// @brief The speed factor
+	double _speed;
+	/// @brief The time the replay was started
+	std::chrono::steady_clock::time_point _startTime { std::chrono::steady_clock::now() };
+};
+
+} // namespace xentara::plugins::templateDriver
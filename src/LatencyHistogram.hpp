@@ -0,0 +1,135 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A lock-free histogram of durations.
+///
+/// The histogram uses logarithmic buckets with four sub-buckets per power of two, so percentiles are accurate to
+/// within 25%, regardless of magnitude. Recording a value costs two or three relaxed atomic operations and never
+/// allocates memory, so the histogram can be used on the cyclic paths.
+class LatencyHistogram final
+{
+public:
+	/// @brief Records a duration
+	auto record(std::chrono::nanoseconds duration) noexcept -> void
+	{
+		const auto value = std::uint64_t(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+
+		_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		_count.fetch_add(1, std::memory_order_relaxed);
+
+		// Update the maximum
+		auto maximum = _maximum.load(std::memory_order_relaxed);
+		while (value > maximum && !_maximum.compare_exchange_weak(maximum, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	/// @brief Returns the number of recorded durations
+	auto count() const noexcept -> std::uint64_t
+	{
+		return _count.load(std::memory_order_relaxed);
+	}
+
+	/// @brief Returns the largest recorded duration
+	auto maximum() const noexcept -> std::chrono::nanoseconds
+	{
+		return std::chrono::nanoseconds(_maximum.load(std::memory_order_relaxed));
+	}
+
+	/// @brief Returns an upper bound for a percentile of the recorded durations
+	/// @param fraction The percentile as a fraction, e.g. 0.99 for the 99th percentile
+	/// @return The upper bound of the bucket containing the percentile, or 0 if no durations were recorded
+	auto percentile(double fraction) const noexcept -> std::chrono::nanoseconds
+	{
+		const auto total = count();
+		if (total == 0)
+		{
+			return std::chrono::nanoseconds::zero();
+		}
+
+		const auto target = std::max<std::uint64_t>(std::uint64_t(std::ceil(fraction * double(total))), 1);
+		std::uint64_t accumulated = 0;
+		for (std::size_t index = 0; index < kBucketCount; ++index)
+		{
+			accumulated += _buckets[index].load(std::memory_order_relaxed);
+			if (accumulated >= target)
+			{
+				return std::min(std::chrono::nanoseconds(bucketUpperBound(index)), maximum());
+			}
+		}
+
+		return maximum();
+	}
+
+	/// @brief Clears the histogram
+	///
+	/// This is not atomic with respect to concurrent calls to record().
+	auto reset() noexcept -> void
+	{
+		for (auto &bucket : _buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		_count.store(0, std::memory_order_relaxed);
+		_maximum.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	/// @brief The number of sub-buckets per power of two
+	static constexpr std::size_t kSubBuckets = 4;
+	/// @brief The total number of buckets
+	static constexpr std::size_t kBucketCount = 64 * kSubBuckets;
+
+	/// @brief Determines the bucket for a value
+	static constexpr auto bucketIndex(std::uint64_t value) noexcept -> std::size_t
+	{
+		// Values below 4 get their own bucket
+		if (value < kSubBuckets)
+		{
+			return std::size_t(value);
+		}
+
+		// Use the highest bit for the power of two and the two bits after it for the sub-bucket
+		const auto highestBit = std::size_t(std::bit_width(value) - 1);
+		const auto subBucket = std::size_t(value >> (highestBit - 2)) & (kSubBuckets - 1);
+		return highestBit * kSubBuckets + subBucket;
+	}
+
+	/// @brief Determines the largest value that falls into a bucket
+	static constexpr auto bucketUpperBound(std::size_t index) noexcept -> std::uint64_t
+	{
+		if (index < kSubBuckets)
+		{
+			return index;
+		}
+
+		const auto highestBit = index / kSubBuckets;
+		const auto subBucket = index % kSubBuckets;
+		if (highestBit >= 63 && subBucket == kSubBuckets - 1)
+		{
+			return ~std::uint64_t(0);
+		}
+		return ((kSubBuckets + subBucket + 1) << (highestBit - 2)) - 1;
+	}
+
+	/// @brief The buckets
+	std::array<std::atomic<std::uint64_t>, kBucketCount> _buckets {};
+	/// @brief The total number of recorded durations
+	std::atomic<std::uint64_t> _count { 0 };
+	/// @brief The largest recorded duration in nanoseconds
+	std::atomic<std::uint64_t> _maximum { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
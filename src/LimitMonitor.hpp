@@ -0,0 +1,123 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Checks the value of a data point against alarm limits.
+///
+/// The monitor supports a high-high, a high, a low, and a low-low limit. The alarm state is a signed level: 0 if the
+/// value is within the limits, 1 or 2 if the high or high-high limit is violated, and -1 or -2 if the low or low-low limit
+/// is violated. Once a limit is violated, the value must return past the limit by the dead band before the violation ends.
+/// A new alarm state only takes effect once it has persisted for the on delay if it is more severe than the current one,
+/// or for the off delay if it is less severe.
+///
+/// The limits are compared without branching, so that evaluating the limits costs about the same whether they are
+/// violated or not. Limits that are not used are set to infinity, and are never violated.
+///
+/// The object has a fixed size and never allocates memory, so it can be used on the read path.
+class LimitMonitor final
+{
+public:
+	/// @brief The limits. Limits that are not used are left at infinity.
+	struct Limits final
+	{
+		/// @brief The low-low limit
+		double _lowLow { -std::numeric_limits<double>::infinity() };
+		/// @brief The low limit
+		double _low { -std::numeric_limits<double>::infinity() };
+		/// @brief The high limit
+		double _high { std::numeric_limits<double>::infinity() };
+		/// @brief The high-high limit
+		double _highHigh { std::numeric_limits<double>::infinity() };
+	};
+
+	/// @brief Creates a monitor
+	/// @param limits The limits. The limits must be in ascending order.
+	/// @param deadBand How far the value must return past a violated limit before the violation ends
+	/// @param onDelay How long a more severe alarm state must persist before it takes effect
+	/// @param offDelay How long a less severe alarm state must persist before it takes effect
+	LimitMonitor(const Limits &limits, double deadBand, std::chrono::nanoseconds onDelay, std::chrono::nanoseconds offDelay) noexcept :
+		_limits(limits),
+		_deadBand(deadBand),
+		_onDelay(onDelay),
+		_offDelay(offDelay)
+	{
+	}
+
+	/// @brief Evaluates the limits for a newly read value
+	/// @param timeStamp The time stamp of the read
+	/// @param value The value that was read
+	/// @param alarmState The current alarm state
+	/// @return The new alarm state
+	auto evaluate(std::chrono::system_clock::time_point timeStamp, double value, std::int8_t alarmState) noexcept -> std::int8_t
+	{
+		// Values that cannot be compared leave the alarm state alone
+		if (std::isnan(value))
+		{
+			return alarmState;
+		}
+
+		// Shift the limits that are currently violated by the dead band, and count the violated limits on either side
+		const auto high = int(value > _limits._high - (alarmState >= 1 ? _deadBand : 0.0)) +
+			int(value > _limits._highHigh - (alarmState >= 2 ? _deadBand : 0.0));
+		const auto low = int(value < _limits._low + (alarmState <= -1 ? _deadBand : 0.0)) +
+			int(value < _limits._lowLow + (alarmState <= -2 ? _deadBand : 0.0));
+		const auto target = std::int8_t(high - low);
+
+		// Nothing is pending if the alarm state stays the same
+		if (target == alarmState)
+		{
+			_pendingState = alarmState;
+			return alarmState;
+		}
+
+		// Start timing the new alarm state when it first appears
+		if (target != _pendingState)
+		{
+			_pendingState = target;
+			_pendingSince = timeStamp;
+		}
+
+		// Use the on delay for more severe alarm states, including a jump from one side to the other
+		const auto moreSevere = std::abs(target) > std::abs(alarmState) || target * alarmState < 0;
+		const auto delay = moreSevere ? _onDelay : _offDelay;
+
+		return timeStamp - _pendingSince >= delay ? target : alarmState;
+	}
+
+	/// @brief Handles a read error
+	///
+	/// The alarm state is kept, but a pending alarm state must persist for its full delay again once the data point
+	/// can be read successfully again.
+	auto observeError() noexcept -> void
+	{
+		_pendingState = kNoPendingState;
+	}
+
+private:
+	/// @brief A value for _pendingState that never matches an alarm state
+	static constexpr std::int8_t kNoPendingState { std::numeric_limits<std::int8_t>::min() };
+
+	/// @brief The limits
+	Limits _limits;
+	/// @brief How far the value must return past a violated limit before the violation ends
+	double _deadBand;
+	/// @brief How long a more severe alarm state must persist before it takes effect
+	std::chrono::nanoseconds _onDelay;
+	/// @brief How long a less severe alarm state must persist before it takes effect
+	std::chrono::nanoseconds _offDelay;
+
+	/// @brief The alarm state that is waiting for its delay to pass
+	std::int8_t _pendingState { 0 };
+	/// @brief The time at which the pending alarm state first appeared
+	std::chrono::system_clock::time_point _pendingSince { std::chrono::system_clock::time_point::min() };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
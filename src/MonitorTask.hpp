@@ -0,0 +1,45 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/process/Task.hpp>
+#include <xentara/process/ExecutionContext.hpp>
+
+#include <functional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief This class providing callbacks for the Xentara scheduler for the "monitor" task of I/O components
+template <typename Target>
+class MonitorTask final : public process::Task
+{
+public:
+	/// @brief This constuctor attached the task to its target
+	MonitorTask(std::reference_wrapper<Target> target) : _target(target)
+	{
+	}
+
+	/// @name Virtual Overrides for process::Task
+	/// @{
+
+	auto stages() const -> Stages final
+	{
+		return Stage::Operational;
+	}
+
+	auto operational(const process::ExecutionContext &context) -> void final;
+		
+	/// @}
+
+private:
+	/// @brief A reference to the target element
+	std::reference_wrapper<Target> _target;
+};
+
+template <typename Target>
+auto MonitorTask<Target>::operational(const process::ExecutionContext &context) -> void
+{
+	_target.get().performMonitorTask(context);
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,178 @@
+// Copyright (c) embedded ocean GmbH
+#include "NoAllocationScope.hpp"
+
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+#	include <algorithm>
+#	include <cstdio>
+#	include <cstdlib>
+#	include <new>
+#	if !defined(_WIN32)
+#		include <dlfcn.h>
+#	endif
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+thread_local std::size_t NoAllocationScope::_depth { 0 };
+
+} // namespace xentara::plugins::templateDriver
+
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+
+namespace
+{
+
+	/// @brief Checks that an allocation is allowed, and aborts the program if it is not
+	auto checkAllocation(std::size_t size) noexcept -> void
+	{
+		using xentara::plugins::templateDriver::NoAllocationScope;
+
+		if (NoAllocationScope::active()) [[unlikely]]
+		{
+			// Don't call anything that might allocate memory here
+			std::fprintf(stderr, "template driver: %zu bytes allocated on a path that must not allocate memory\n", size);
+			std::abort();
+		}
+	}
+
+	/// @brief Allocates memory with the default alignment
+	auto allocate(std::size_t size) noexcept -> void *
+	{
+		checkAllocation(size);
+		return std::malloc(size != 0 ? size : 1);
+	}
+
+	/// @brief Allocates memory with a specific alignment
+	auto allocate(std::size_t size, std::align_val_t alignment) noexcept -> void *
+	{
+		checkAllocation(size);
+#	if defined(_MSC_VER)
+		return _aligned_malloc(size != 0 ? size : 1, std::size_t(alignment));
+#	else
+		// std::aligned_alloc() requires the size to be a multiple of the alignment
+		const auto alignedSize = (std::max<std::size_t>(size, 1) + std::size_t(alignment) - 1) & ~(std::size_t(alignment) - 1);
+		return std::aligned_alloc(std::size_t(alignment), alignedSize);
+#	endif
+	}
+
+	/// @brief Frees memory allocated with a specific alignment
+	auto deallocate(void *pointer, std::align_val_t) noexcept -> void
+	{
+#	if defined(_MSC_VER)
+		_aligned_free(pointer);
+#	else
+		std::free(pointer);
+#	endif
+	}
+
+} // namespace
+
+// The replaced allocation functions. The throwing versions throw std::bad_alloc if no memory is available; the checks
+// happen before any allocation, so the diagnostic is printed even if the allocation would have failed.
+
+auto operator new(std::size_t size) -> void *
+{
+	if (auto pointer = allocate(size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size) -> void *
+{
+	return operator new(size);
+}
+
+auto operator new(std::size_t size, const std::nothrow_t &) noexcept -> void *
+{
+	return allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t &) noexcept -> void *
+{
+	return allocate(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void *
+{
+	if (auto pointer = allocate(size, alignment))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void *
+{
+	return operator new(size, alignment);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept -> void *
+{
+	return allocate(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept -> void *
+{
+	return allocate(size, alignment);
+}
+
+auto operator delete(void *pointer) noexcept -> void
+{
+	std::free(pointer);
+}
+
+auto operator delete[](void *pointer) noexcept -> void
+{
+	std::free(pointer);
+}
+
+auto operator delete(void *pointer, std::size_t) noexcept -> void
+{
+	std::free(pointer);
+}
+
+auto operator delete[](void *pointer, std::size_t) noexcept -> void
+{
+	std::free(pointer);
+}
+
+auto operator delete(void *pointer, std::align_val_t alignment) noexcept -> void
+{
+	deallocate(pointer, alignment);
+}
+
+auto operator delete[](void *pointer, std::align_val_t alignment) noexcept -> void
+{
+	deallocate(pointer, alignment);
+}
+
+auto operator delete(void *pointer, std::size_t, std::align_val_t alignment) noexcept -> void
+{
+	deallocate(pointer, alignment);
+}
+
+auto operator delete[](void *pointer, std::size_t, std::align_val_t alignment) noexcept -> void
+{
+	deallocate(pointer, alignment);
+}
+
+#	if !defined(_WIN32)
+
+// The C++ runtime allocates exceptions using malloc(), not operator new, so throwing an exception is checked separately.
+// Because the plugin is linked with -Bsymbolic, the exceptions it throws are allocated using this function, which checks
+// the allocation and then forwards to the function of the C++ runtime.
+extern "C" auto __cxa_allocate_exception(std::size_t size) noexcept -> void *
+{
+	checkAllocation(size);
+
+	using AllocateFunction = void *(*)(std::size_t) noexcept;
+	static const auto next = reinterpret_cast<AllocateFunction>(::dlsym(RTLD_NEXT, "__cxa_allocate_exception"));
+	return next(size);
+}
+
+#	endif
+
+#endif
\ No newline at end of file
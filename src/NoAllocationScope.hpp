@@ -0,0 +1,88 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Marks a code path that must not allocate memory.
+///
+/// The cyclic paths of the driver are placed inside such a scope. In normal builds, the scope does nothing at all.
+/// If the driver is built with the CMake option TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS, the global allocation
+/// functions are replaced, and abort the program with a diagnostic message if memory is allocated inside a scope on
+/// the same thread. Except under Windows, this includes the memory allocated for exceptions thrown by the driver.
+///
+/// Allocations that are known to happen only once, like the creation of a per-thread buffer on first use, can be
+/// allowed using an @ref Exemption.
+class NoAllocationScope final
+{
+public:
+	/// @brief Allows allocations inside a NoAllocationScope for the lifetime of the object
+	class Exemption final
+	{
+	public:
+		/// @brief Suspends all enclosing scopes of the current thread
+		Exemption() noexcept
+		{
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+			_depth = std::exchange(NoAllocationScope::_depth, 0);
+#endif
+		}
+
+		/// @brief Resumes the enclosing scopes
+		~Exemption()
+		{
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+			NoAllocationScope::_depth = _depth;
+#endif
+		}
+
+		/// @brief Deleted copy constructor
+		Exemption(const Exemption &) = delete;
+		/// @brief Deleted assignment operator
+		auto operator=(const Exemption &) -> Exemption & = delete;
+
+	private:
+		/// @brief The depth of the enclosing scopes
+		[[maybe_unused]] std::size_t _depth { 0 };
+	};
+
+	/// @brief Enters the scope
+	NoAllocationScope() noexcept
+	{
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+		++_depth;
+#endif
+	}
+
+	/// @brief Leaves the scope
+	~NoAllocationScope()
+	{
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+		--_depth;
+#endif
+	}
+
+	/// @brief Deleted copy constructor
+	NoAllocationScope(const NoAllocationScope &) = delete;
+	/// @brief Deleted assignment operator
+	auto operator=(const NoAllocationScope &) -> NoAllocationScope & = delete;
+
+	/// @brief Returns whether the current thread is inside a scope. This is always false if verification is disabled.
+	static auto active() noexcept -> bool
+	{
+#if defined(TEMPLATE_DRIVER_VERIFY_NO_ALLOCATIONS)
+		return _depth != 0;
+#else
+		return false;
+#endif
+	}
+
+private:
+	/// @brief The number of scopes the current thread is in
+	static thread_local std::size_t _depth;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
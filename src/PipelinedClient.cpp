@@ -0,0 +1,505 @@
+// Copyright (c) embedded ocean GmbH
+#include "PipelinedClient.hpp"
+
+#include "CustomError.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(__unix__)
+#	include <fcntl.h>
+#	include <netdb.h>
+#	include <netinet/in.h>
+#	include <netinet/tcp.h>
+#	include <poll.h>
+#	include <sys/socket.h>
+#	include <sys/un.h>
+#	include <unistd.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+namespace
+{
+
+	/// @brief The prefix of addresses of UNIX domain sockets
+	constexpr auto kUnixPrefix = "unix:"sv;
+	/// @brief The prefix of addresses of TCP sockets
+	constexpr auto kTcpPrefix = "tcp:"sv;
+
+} // namespace
+
+auto PipelinedClient::isValidAddress(std::string_view address) noexcept -> bool
+{
+	if (address.starts_with(kUnixPrefix))
+	{
+		return address.size() > kUnixPrefix.size();
+	}
+	else if (address.starts_with(kTcpPrefix))
+	{
+		// We need a host and a port
+		const auto separator = address.rfind(':');
+		return separator > kTcpPrefix.size() && separator + 1 < address.size();
+	}
+
+	return false;
+}
+
+PipelinedClient::PipelinedClient(std::string address, std::size_t window, std::chrono::nanoseconds timeout, ReconnectBackoff backoff,
+	Completion completion, ConnectionHandler connectionHandler) :
+	_address(std::move(address)),
+	_timeout(timeout),
+	_backoff(backoff),
+	_completion(std::move(completion)),
+	_connectionHandler(std::move(connectionHandler)),
+	_slots(window)
+{
+}
+
+PipelinedClient::~PipelinedClient()
+{
+	stop();
+}
+
+auto PipelinedClient::read(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp)
+	-> utils::eh::expected<std::uint32_t, std::error_code>
+{
+	std::scoped_lock lock { _mutex };
+
+	// Fail right away if we are not connected, or if the window is full. Waiting for a slot would stall the calling task
+	// for up to the request timeout.
+	if (_socket < 0)
+	{
+		return utils::eh::unexpected(CustomError::NotConnected);
+	}
+	if (_inFlight >= _slots.size())
+	{
+		return utils::eh::unexpected(CustomError::Busy);
+	}
+
+	// Find the next transaction ID whose slot is free
+	auto transactionId = _nextTransactionId++;
+	while (_slots[transactionId % _slots.size()]._transactionId)
+	{
+		transactionId = _nextTransactionId++;
+	}
+
+	// Send the request. This is done while holding the lock, so the frames of different threads don't get mixed up. The
+	// request is sent without blocking, so that a device that stops reading cannot stall the calling task while it holds
+	// the lock.
+	const RequestFrame request { transactionId, std::uint32_t(pointIndex) };
+#if defined(__unix__)
+	const auto sent = ::send(_socket, &request, sizeof(request), MSG_NOSIGNAL | MSG_DONTWAIT);
+	if (sent < 0)
+	{
+		// If the send buffer is full, nothing was sent, so the connection is still usable
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			return utils::eh::unexpected(CustomError::Busy);
+		}
+		return utils::eh::unexpected(std::error_code(errno, std::generic_category()));
+	}
+	// If only part of the frame was sent, the device can no longer tell where the next frame starts. Shut the connection
+	// down, so that the receiver thread fails the requests in flight and reconnects.
+	if (std::size_t(sent) != sizeof(request))
+	{
+		::shutdown(_socket, SHUT_RDWR);
+		return utils::eh::unexpected(std::make_error_code(std::errc::connection_aborted));
+	}
+#endif
+
+	// Fill in the slot
+	_slots[transactionId % _slots.size()] = { transactionId, pointIndex, timeStamp, std::chrono::steady_clock::now() + _timeout };
+	++_inFlight;
+
+	return transactionId;
+}
+
+auto PipelinedClient::cancel(std::uint32_t transactionId) noexcept -> bool
+{
+	std::scoped_lock lock { _mutex };
+	return release(transactionId).has_value();
+}
+
+auto PipelinedClient::release(std::uint32_t transactionId) noexcept -> std::optional<Slot>
+{
+	auto &slot = _slots[transactionId % _slots.size()];
+	if (slot._transactionId != transactionId)
+	{
+		return std::nullopt;
+	}
+
+	auto contents = std::exchange(slot, {});
+	--_inFlight;
+	return contents;
+}
+
+auto PipelinedClient::expire(std::chrono::steady_clock::time_point now) -> std::optional<std::chrono::steady_clock::time_point>
+{
+	std::optional<std::chrono::steady_clock::time_point> nextDeadline;
+
+	for (auto &slot : _slots)
+	{
+		std::optional<Slot> expired;
+		{
+			std::scoped_lock lock { _mutex };
+			if (!slot._transactionId)
+			{
+				continue;
+			}
+			if (slot._deadline <= now)
+			{
+				expired = release(*slot._transactionId);
+			}
+			else if (!nextDeadline || slot._deadline < *nextDeadline)
+			{
+				nextDeadline = slot._deadline;
+			}
+		}
+
+		// Complete the request outside the lock
+		if (expired)
+		{
+			_completion(*expired->_transactionId, expired->_pointIndex, expired->_timeStamp, utils::eh::unexpected(std::make_error_code(std::errc::timed_out)));
+		}
+	}
+
+	return nextDeadline;
+}
+
+auto PipelinedClient::failAll(std::error_code error) -> void
+{
+	for (auto &slot : _slots)
+	{
+		std::optional<Slot> failed;
+		{
+			std::scoped_lock lock { _mutex };
+			if (slot._transactionId)
+			{
+				failed = release(*slot._transactionId);
+			}
+		}
+
+		if (failed)
+		{
+			_completion(*failed->_transactionId, failed->_pointIndex, failed->_timeStamp, utils::eh::unexpected(error));
+		}
+	}
+}
+
+#if defined(__unix__)
+
+namespace
+{
+
+	/// @brief Connects a non-blocking socket, unless a wake-up pipe becomes readable first
+	/// @return The connected socket in blocking mode, or an error
+	auto connectSocket(const ::addrinfo &address, int wakeUpFd) -> utils::eh::expected<int, std::error_code>
+	{
+		const auto socket = ::socket(address.ai_family, address.ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, address.ai_protocol);
+		if (socket < 0)
+		{
+			return utils::eh::unexpected(std::error_code(errno, std::generic_category()));
+		}
+
+		const auto fail = [socket](std::error_code error) {
+			::close(socket);
+			return utils::eh::unexpected(error);
+		};
+
+		if (::connect(socket, address.ai_addr, address.ai_addrlen) < 0)
+		{
+			if (errno != EINPROGRESS)
+			{
+				return fail(std::error_code(errno, std::generic_category()));
+			}
+
+			// Wait for the connection to complete, or for the client to be stopped
+			::pollfd pollInfo[] { { .fd = socket, .events = POLLOUT, .revents = 0 }, { .fd = wakeUpFd, .events = POLLIN, .revents = 0 } };
+			while (::poll(pollInfo, 2, -1) < 0)
+			{
+				if (errno != EINTR)
+				{
+					return fail(std::error_code(errno, std::generic_category()));
+				}
+			}
+			if (pollInfo[1].revents != 0)
+			{
+				return fail(std::make_error_code(std::errc::operation_canceled));
+			}
+
+			// Check if the connection succeeded
+			int error = 0;
+			::socklen_t errorSize = sizeof(error);
+			::getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &errorSize);
+			if (error != 0)
+			{
+				return fail(std::error_code(error, std::generic_category()));
+			}
+		}
+
+		// Responses are received using blocking calls. Requests are sent with MSG_DONTWAIT instead, see read().
+		::fcntl(socket, F_SETFL, ::fcntl(socket, F_GETFL) & ~O_NONBLOCK);
+
+		// Don't delay small request frames on TCP connections
+		if (address.ai_family != AF_UNIX)
+		{
+			int noDelay = 1;
+			::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		}
+
+		return socket;
+	}
+
+} // namespace
+
+auto PipelinedClient::start() -> void
+{
+	// Create the pipe used to wake up the receiver thread
+	if (::pipe2(_wakeUpPipe, O_CLOEXEC) < 0)
+	{
+		throw std::system_error(errno, std::generic_category(), "could not create wake-up pipe for " + _address);
+	}
+
+	// Start the receiver thread, which makes the connection
+	_thread = std::jthread([this](std::stop_token stopToken) { run(stopToken); });
+}
+
+auto PipelinedClient::stop() -> void
+{
+	// Wake up the receiver thread using the pipe, and wait for it to finish
+	if (_thread.joinable())
+	{
+		_thread.request_stop();
+		const char wakeUp = 0;
+		[[maybe_unused]] const auto written = ::write(_wakeUpPipe[1], &wakeUp, sizeof(wakeUp));
+		_thread.join();
+	}
+
+	// Close the pipe
+	for (auto &fd : _wakeUpPipe)
+	{
+		if (fd >= 0)
+		{
+			::close(std::exchange(fd, -1));
+		}
+	}
+}
+
+auto PipelinedClient::run(std::stop_token stopToken) -> void
+{
+	while (!stopToken.stop_requested())
+	{
+		// Connect to the server, and wait before trying again if that failed
+		const auto socket = connect();
+		if (!socket)
+		{
+			/// @todo log the error
+			if (waitForRetry(_backoff.next()))
+			{
+				break;
+			}
+			continue;
+		}
+		{
+			std::scoped_lock lock { _mutex };
+			_socket = *socket;
+		}
+		_backoff.reset();
+		if (_connectionHandler)
+		{
+			_connectionHandler({});
+		}
+
+		// Receive responses until the connection is lost
+		const auto error = receive();
+
+		// Close the connection, and fail all requests still in flight. New reads fail right away from now on.
+		{
+			std::scoped_lock lock { _mutex };
+			::close(std::exchange(_socket, -1));
+		}
+		failAll(error ? error : std::make_error_code(std::errc::operation_canceled));
+
+		// Report the lost connection, unless we were stopped
+		if (error && _connectionHandler)
+		{
+			_connectionHandler(error);
+		}
+	}
+}
+
+auto PipelinedClient::connect() -> utils::eh::expected<int, std::error_code>
+{
+	::addrinfo hints {};
+	::addrinfo *addresses = nullptr;
+	::sockaddr_un unixAddress {};
+	::addrinfo unixInfo {};
+
+	// Build the address of a UNIX domain socket
+	if (std::string_view(_address).starts_with(kUnixPrefix))
+	{
+		unixAddress.sun_family = AF_UNIX;
+		const auto path = std::string_view(_address).substr(kUnixPrefix.size());
+		if (path.size() >= sizeof(unixAddress.sun_path))
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::filename_too_long));
+		}
+		std::ranges::copy(path, unixAddress.sun_path);
+
+		unixInfo.ai_family = AF_UNIX;
+		unixInfo.ai_socktype = SOCK_STREAM;
+		unixInfo.ai_addr = reinterpret_cast<::sockaddr *>(&unixAddress);
+		unixInfo.ai_addrlen = sizeof(unixAddress);
+	}
+	// Resolve the address of a TCP socket. This is done for each attempt, in case the address of the host changed.
+	else
+	{
+		const auto separator = _address.rfind(':');
+		const auto host = _address.substr(kTcpPrefix.size(), separator - kTcpPrefix.size());
+		const auto port = _address.substr(separator + 1);
+
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::host_unreachable));
+		}
+	}
+
+	// Try all the addresses in turn
+	utils::eh::expected<int, std::error_code> socket = utils::eh::unexpected(std::make_error_code(std::errc::host_unreachable));
+	for (auto address = addresses ? addresses : &unixInfo; address; address = address->ai_next)
+	{
+		socket = connectSocket(*address, _wakeUpPipe[0]);
+		if (socket || socket.error() == std::errc::operation_canceled)
+		{
+			break;
+		}
+	}
+	if (addresses)
+	{
+		::freeaddrinfo(addresses);
+	}
+
+	return socket;
+}
+
+auto PipelinedClient::receive() -> std::error_code
+{
+	// A buffer for partially received frames
+	std::array<std::byte, 64 * sizeof(ResponseFrame)> buffer;
+	std::size_t buffered = 0;
+
+	while (true)
+	{
+		// Wait for data, or until the next request times out, or until we are stopped
+		const auto nextDeadline = expire(std::chrono::steady_clock::now());
+		const auto timeout = nextDeadline ?
+			std::max(int(std::chrono::ceil<std::chrono::milliseconds>(*nextDeadline - std::chrono::steady_clock::now()).count()), 0) : -1;
+		::pollfd pollInfo[] { { .fd = _socket, .events = POLLIN, .revents = 0 }, { .fd = _wakeUpPipe[0], .events = POLLIN, .revents = 0 } };
+		const auto ready = ::poll(pollInfo, 2, timeout);
+		if (ready < 0 && errno != EINTR)
+		{
+			return std::error_code(errno, std::generic_category());
+		}
+		if (pollInfo[1].revents != 0)
+		{
+			return {};
+		}
+		if (ready <= 0)
+		{
+			continue;
+		}
+
+		// Receive as many frames as are available
+		const auto received = ::recv(_socket, buffer.data() + buffered, buffer.size() - buffered, 0);
+		if (received <= 0)
+		{
+			return received == 0 ? std::make_error_code(std::errc::connection_reset) : std::error_code(errno, std::generic_category());
+		}
+		buffered += std::size_t(received);
+
+		// Complete the requests of all the complete frames
+		std::size_t offset = 0;
+		for (; buffered - offset >= sizeof(ResponseFrame); offset += sizeof(ResponseFrame))
+		{
+			ResponseFrame response;
+			std::memcpy(&response, buffer.data() + offset, sizeof(response));
+
+			std::optional<Slot> completed;
+			{
+				std::scoped_lock lock { _mutex };
+				completed = release(response._transactionId);
+			}
+
+			// Discard responses to requests that timed out or were cancelled
+			if (!completed)
+			{
+				continue;
+			}
+
+			if (response._error != 0)
+			{
+				_completion(response._transactionId, completed->_pointIndex, completed->_timeStamp,
+					utils::eh::unexpected(std::error_code(response._error, std::generic_category())));
+			}
+			else
+			{
+				_completion(response._transactionId, completed->_pointIndex, completed->_timeStamp, response._value);
+			}
+		}
+
+		// Keep any partial frame for the next time
+		std::memmove(buffer.data(), buffer.data() + offset, buffered - offset);
+		buffered -= offset;
+	}
+}
+
+auto PipelinedClient::waitForRetry(std::chrono::nanoseconds delay) -> bool
+{
+	// Wait on the wake-up pipe, so that stop() does not have to wait for the delay to pass
+	::pollfd pollInfo { .fd = _wakeUpPipe[0], .events = POLLIN, .revents = 0 };
+	const auto timeout = int(std::chrono::ceil<std::chrono::milliseconds>(delay).count());
+	return ::poll(&pollInfo, 1, timeout) > 0;
+}
+
+#else
+
+auto PipelinedClient::start() -> void
+{
+	throw std::system_error(std::make_error_code(std::errc::operation_not_supported), "pipelined clients are not supported on this system");
+}
+
+auto PipelinedClient::stop() -> void
+{
+}
+
+auto PipelinedClient::run(std::stop_token stopToken) -> void
+{
+}
+
+auto PipelinedClient::connect() -> utils::eh::expected<int, std::error_code>
+{
+	return utils::eh::unexpected(std::make_error_code(std::errc::operation_not_supported));
+}
+
+auto PipelinedClient::receive() -> std::error_code
+{
+	return std::make_error_code(std::errc::operation_not_supported);
+}
+
+auto PipelinedClient::waitForRetry(std::chrono::nanoseconds delay) -> bool
+{
+	return true;
+}
+
+#endif
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
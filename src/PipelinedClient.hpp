@@ -0,0 +1,194 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ReconnectBackoff.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A client for request/response devices that keeps several requests in flight at once.
+///
+/// Instead of waiting a full round trip for each read, the client sends up to a configurable window of requests
+/// before waiting for any response. Each request carries a transaction ID, which the device echoes in its response,
+/// so the responses can arrive in any order. A receiver thread matches the responses to their requests, and reports
+/// the results using a completion function. Requests that are not answered in time complete with an error, and late
+/// responses to them are discarded.
+///
+/// The connection is managed by the receiver thread. If the connection cannot be established or is lost, the thread
+/// keeps trying to reconnect in the background, backing off between attempts. While the client is not connected, reads
+/// fail right away with CustomError::NotConnected, so the calling tasks are never stalled by a connection attempt.
+///
+/// The requests and responses are exchanged as fixed-size frames in native byte order, see @ref RequestFrame and
+/// @ref ResponseFrame.
+///
+/// @todo adapt the frames to the protocol of the device
+class PipelinedClient final
+{
+public:
+	/// @brief A request, as sent to the device
+	struct RequestFrame final
+	{
+		/// @brief The transaction ID
+		std::uint32_t _transactionId { 0 };
+		/// @brief The index of the data point to read
+		std::uint32_t _pointIndex { 0 };
+	};
+
+	/// @brief A response, as received from the device
+	struct ResponseFrame final
+	{
+		/// @brief The transaction ID of the request
+		std::uint32_t _transactionId { 0 };
+		/// @brief An error code from std::generic_category(), or 0 on success
+		std::int32_t _error { 0 };
+		/// @brief The value
+		/// @todo use the correct value type
+		double _value { 0 };
+	};
+
+	/// @brief The function called when a request completes
+	///
+	/// The function is called with the transaction ID and the index of the data point, the time stamp passed to read(),
+	/// and the value or error. It is always called on the receiver thread.
+	/// @todo use the correct value type
+	using Completion = std::function<void(std::uint32_t transactionId, std::size_t pointIndex,
+		std::chrono::system_clock::time_point timeStamp, const utils::eh::expected<double, std::error_code> &valueOrError)>;
+
+	/// @brief The function called when the connection is established or lost
+	///
+	/// The function is called on the receiver thread with no error when the connection was established, and with the
+	/// reason when an established connection was lost. It is not called when the client is stopped.
+	using ConnectionHandler = std::function<void(std::error_code error)>;
+
+	/// @brief Whether the client is supported on this system
+#if defined(__unix__)
+	static constexpr bool kSupported { true };
+#else
+	static constexpr bool kSupported { false };
+#endif
+
+	/// @brief Checks whether a server address is valid
+	/// @param address The address, either "unix:<path>" or "tcp:<host>:<port>"
+	static auto isValidAddress(std::string_view address) noexcept -> bool;
+
+	/// @brief Creates a client
+	/// @param address The address of the server, either "unix:<path>" or "tcp:<host>:<port>"
+	/// @param window The maximum number of requests in flight at the same time, at most 65536
+	/// @param timeout The time after which a request that has not been answered fails
+	/// @param backoff Determines the delays between attempts to connect
+	/// @param completion The function called when a request completes
+	/// @param connectionHandler The function called when the connection is established or lost, if any
+	PipelinedClient(std::string address, std::size_t window, std::chrono::nanoseconds timeout, ReconnectBackoff backoff,
+		Completion completion, ConnectionHandler connectionHandler = {});
+
+	/// @brief Destructor. Stops the client if it is still running.
+	~PipelinedClient();
+
+	/// @brief Starts the receiver thread, which connects to the server in the background
+	/// @throw std::system_error if the thread could not be started
+	auto start() -> void;
+
+	/// @brief Stops the receiver thread, and completes all requests still in flight with an error
+	auto stop() -> void;
+
+	/// @brief Sends a read request.
+	///
+	/// This function never blocks. If the window is full, or the socket cannot take the request right away, it fails with
+	/// CustomError::Busy. If only part of the request could be sent, the connection is closed and reestablished.
+	/// @param pointIndex The index of the data point to read
+	/// @param timeStamp The time stamp to pass to the completion function
+	/// @return The transaction ID of the request, or an error if the request could not be sent. If the client is not
+	/// connected, the error is CustomError::NotConnected. No completion function is called for requests that could not be
+	/// sent.
+	auto read(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp) -> utils::eh::expected<std::uint32_t, std::error_code>;
+
+	/// @brief Cancels a request. Its completion function is not called, and any response is discarded.
+	/// @param transactionId The transaction ID returned by read()
+	/// @return Whether the request was still in flight
+	auto cancel(std::uint32_t transactionId) noexcept -> bool;
+
+private:
+	/// @brief A slot for a request in flight
+	struct Slot final
+	{
+		/// @brief The transaction ID, or std::nullopt if the slot is free
+		std::optional<std::uint32_t> _transactionId;
+		/// @brief The index of the data point
+		std::size_t _pointIndex { 0 };
+		/// @brief The time stamp to pass to the completion function
+		std::chrono::system_clock::time_point _timeStamp;
+		/// @brief The time after which the request fails
+		std::chrono::steady_clock::time_point _deadline;
+	};
+
+	/// @brief Frees the slot of a request, and returns what is needed to complete it
+	/// @return The slot contents, or std::nullopt if the request is no longer in flight
+	/// @note The mutex must be locked
+	auto release(std::uint32_t transactionId) noexcept -> std::optional<Slot>;
+
+	/// @brief The thread function of the receiver thread, which connects, receives, and reconnects
+	auto run(std::stop_token stopToken) -> void;
+
+	/// @brief Connects to the server
+	/// @return The socket, or an error. If stop() was called, the error is std::errc::operation_canceled.
+	auto connect() -> utils::eh::expected<int, std::error_code>;
+
+	/// @brief Receives responses until the connection is lost or the client is stopped
+	/// @return The error that closed the connection, or no error if the client was stopped
+	auto receive() -> std::error_code;
+
+	/// @brief Waits before the next attempt to connect
+	/// @return Whether stop() was called while waiting
+	auto waitForRetry(std::chrono::nanoseconds delay) -> bool;
+
+	/// @brief Fails all requests whose deadline has passed
+	/// @return The next deadline of a request in flight, if any
+	auto expire(std::chrono::steady_clock::time_point now) -> std::optional<std::chrono::steady_clock::time_point>;
+
+	/// @brief Fails all requests in flight, e.g. because the connection was lost
+	auto failAll(std::error_code error) -> void;
+
+	/// @brief The address of the server
+	std::string _address;
+	/// @brief The time after which a request fails
+	std::chrono::nanoseconds _timeout;
+	/// @brief Determines the delays between attempts to connect
+	ReconnectBackoff _backoff;
+	/// @brief The completion function
+	Completion _completion;
+	/// @brief The connection handler
+	ConnectionHandler _connectionHandler;
+
+	/// @brief The socket, or -1 if not connected
+	int _socket { -1 };
+	/// @brief A pipe that wakes up the receiver thread when the client is stopped, or -1 if not running
+	int _wakeUpPipe[2] { -1, -1 };
+
+	/// @brief The slots for the requests in flight. The slot of a request is its transaction ID modulo the window size.
+	std::vector<Slot> _slots;
+	/// @brief The number of slots in use
+	std::size_t _inFlight { 0 };
+	/// @brief The next transaction ID to try
+	std::uint32_t _nextTransactionId { 0 };
+	/// @brief A mutex protecting the slots and the sending side of the socket
+	std::mutex _mutex;
+
+	/// @brief The receiver thread
+	std::jthread _thread;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,249 @@
+// Copyright (c) embedded ocean GmbH
+#include "Reactor.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#if defined(__linux__)
+#	include <fcntl.h>
+#	include <sys/epoll.h>
+#	include <sys/eventfd.h>
+#	include <unistd.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief The number of events fetched with each call to epoll_wait()
+	constexpr std::size_t kMaxEvents { 64 };
+
+	/// @brief The epoll user data used for the wake up event. Sources use their index.
+	constexpr std::uint64_t kWakeUpData { UINT64_MAX };
+
+} // namespace
+
+Reactor::~Reactor()
+{
+	stop();
+}
+
+auto Reactor::add(std::filesystem::path path, Handler handler) -> void
+{
+	_sources.push_back({ std::move(path), -1, std::move(handler) });
+}
+
+auto Reactor::add(int fileDescriptor, Handler handler) -> void
+{
+	_sources.push_back({ {}, fileDescriptor, std::move(handler) });
+}
+
+#if defined(__linux__)
+
+auto Reactor::start() -> void
+{
+	// Nothing to do without sources
+	if (_sources.empty())
+	{
+		return;
+	}
+
+	// Create the epoll instance and the wake up event
+	_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+	if (_epoll < 0)
+	{
+		throw std::system_error(errno, std::generic_category(), "could not create epoll instance for push mode");
+	}
+	_wakeUp = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (_wakeUp < 0)
+	{
+		const auto error = errno;
+		close();
+		throw std::system_error(error, std::generic_category(), "could not create wake up event for push mode");
+	}
+	::epoll_event wakeUpEvent { .events = EPOLLIN, .data = { .u64 = kWakeUpData } };
+	::epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeUp, &wakeUpEvent);
+
+	// Open and register all the sources
+	for (std::size_t index = 0; index < _sources.size(); ++index)
+	{
+		auto &source = _sources[index];
+
+		if (!source._path.empty())
+		{
+			source._fileDescriptor = ::open(source._path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+			if (source._fileDescriptor < 0)
+			{
+				const auto error = errno;
+				close();
+				throw std::system_error(error, std::generic_category(), "could not open push mode source " + source._path.string());
+			}
+		}
+
+		::epoll_event event { .events = EPOLLIN, .data = { .u64 = index } };
+		if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, source._fileDescriptor, &event) < 0)
+		{
+			const auto error = errno;
+			close();
+			throw std::system_error(error, std::generic_category(), "could not register push mode source");
+		}
+	}
+
+	// Start the thread
+	_thread = std::jthread([this](std::stop_token stopToken) { run(stopToken); });
+}
+
+auto Reactor::stop() -> void
+{
+	// Wake up the thread and wait for it to finish
+	if (_thread.joinable())
+	{
+		_thread.request_stop();
+		::eventfd_write(_wakeUp, 1);
+		_thread.join();
+	}
+
+	close();
+}
+
+auto Reactor::drain(int fileDescriptor) noexcept -> void
+{
+	std::array<char, 4096> buffer;
+	while (::read(fileDescriptor, buffer.data(), buffer.size()) > 0)
+	{
+	}
+}
+
+auto Reactor::run(std::stop_token stopToken) -> void
+{
+	std::array<::epoll_event, kMaxEvents> events;
+
+	while (!stopToken.stop_requested())
+	{
+		const auto count = ::epoll_wait(_epoll, events.data(), int(events.size()), -1);
+		// Take the time stamp right away, so it is as close to the actual arrival of the data as possible
+		const auto timeStamp = std::chrono::system_clock::now();
+		if (count < 0)
+		{
+			// Interrupted system calls are harmless
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			/// @todo log the error
+			return;
+		}
+
+		for (const auto &event : std::span(events.data(), std::size_t(count)))
+		{
+			if (event.data.u64 == kWakeUpData)
+			{
+				continue;
+			}
+
+			const auto index = std::size_t(event.data.u64);
+			auto &source = _sources[index];
+
+			// Handle the data first, so that data sent right before a hangup is not lost
+			if (event.events & EPOLLIN)
+			{
+				source._handler(source._fileDescriptor, timeStamp, std::error_code());
+			}
+			if (event.events & (EPOLLHUP | EPOLLERR))
+			{
+				hangUp(index, timeStamp);
+			}
+		}
+	}
+}
+
+auto Reactor::hangUp(std::size_t index, std::chrono::system_clock::time_point timeStamp) -> void
+{
+	auto &source = _sources[index];
+
+	// Stop waiting on the source
+	::epoll_ctl(_epoll, EPOLL_CTL_DEL, source._fileDescriptor, nullptr);
+
+	// Sources added by file descriptor are gone for good
+	if (source._path.empty())
+	{
+		source._handler(source._fileDescriptor, timeStamp, std::make_error_code(std::errc::connection_aborted));
+		return;
+	}
+
+	// Reopen sources added by path. A FIFO reports a hangup whenever its last writer goes away, and reopening it
+	// lets us wait for the next writer.
+	::close(source._fileDescriptor);
+	source._fileDescriptor = ::open(source._path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (source._fileDescriptor < 0)
+	{
+		source._handler(-1, timeStamp, std::error_code(errno, std::generic_category()));
+		return;
+	}
+	::epoll_event event { .events = EPOLLIN, .data = { .u64 = index } };
+	::epoll_ctl(_epoll, EPOLL_CTL_ADD, source._fileDescriptor, &event);
+}
+
+auto Reactor::close() noexcept -> void
+{
+	// Close the sources we opened ourselves
+	for (auto &source : _sources)
+	{
+		if (!source._path.empty() && source._fileDescriptor >= 0)
+		{
+			::close(source._fileDescriptor);
+			source._fileDescriptor = -1;
+		}
+	}
+
+	// Close the epoll instance and the wake up event
+	for (auto fileDescriptor : { std::exchange(_epoll, -1), std::exchange(_wakeUp, -1) })
+	{
+		if (fileDescriptor >= 0)
+		{
+			::close(fileDescriptor);
+		}
+	}
+}
+
+#else
+
+auto Reactor::start() -> void
+{
+	// Nothing to do without sources
+	if (_sources.empty())
+	{
+		return;
+	}
+
+	throw std::system_error(std::make_error_code(std::errc::operation_not_supported), "push mode is only supported on Linux");
+}
+
+auto Reactor::stop() -> void
+{
+}
+
+auto Reactor::drain(int fileDescriptor) noexcept -> void
+{
+}
+
+auto Reactor::run(std::stop_token stopToken) -> void
+{
+}
+
+auto Reactor::hangUp(std::size_t index, std::chrono::system_clock::time_point timeStamp) -> void
+{
+}
+
+auto Reactor::close() noexcept -> void
+{
+}
+
+#endif
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,109 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Waits for notifications from file descriptors on a thread of its own, and calls a handler on each one.
+///
+/// This is used for data points in push mode, whose source can notify the driver when new data is available,
+/// like local sockets, FIFOs or IIO buffers. Instead of polling such sources, the reactor waits on all of them
+/// using epoll, and calls the handler of a source as soon as it becomes readable. The handler is passed a time stamp
+/// taken right after the wakeup, which can be used as acquisition time stamp.
+///
+/// The handlers are level-triggered, so they must consume all pending data, e.g. using drain().
+///
+/// @note The reactor is only supported on Linux. On other systems, start() throws an exception if any sources were added.
+class Reactor final
+{
+public:
+	/// @brief The function called when a source becomes readable.
+	///
+	/// The function is called with the file descriptor of the source, and the time stamp of the wakeup. If the source
+	/// was closed by its peer or failed, the function is called once more with the corresponding error, and then the
+	/// source is removed from the reactor. Sources opened by path are reopened instead, after a FIFO writer went away.
+	using Handler = std::function<void(int fileDescriptor, std::chrono::system_clock::time_point timeStamp, std::error_code error)>;
+
+	/// @brief Whether the reactor is supported on this system
+#if defined(__linux__)
+	static constexpr bool kSupported { true };
+#else
+	static constexpr bool kSupported { false };
+#endif
+
+	/// @brief Destructor. Stops the reactor if it is still running.
+	~Reactor();
+
+	/// @brief Adds a source that is opened from a path when the reactor is started
+	///
+	/// The file is opened for non-blocking reading, and closed when the reactor is stopped. This must be called before
+	/// the reactor is started.
+	/// @param path The path of the file, e.g. a FIFO or a character device
+	/// @param handler The function that is called when the source becomes readable
+	auto add(std::filesystem::path path, Handler handler) -> void;
+
+	/// @brief Adds a source that has already been opened, like one end of a pipe or socket pair
+	///
+	/// The file descriptor is not closed by the reactor. This must be called before the reactor is started.
+	/// @param fileDescriptor The file descriptor, which should be in non-blocking mode
+	/// @param handler The function that is called when the source becomes readable
+	auto add(int fileDescriptor, Handler handler) -> void;
+
+	/// @brief Checks whether any sources have been added
+	auto empty() const noexcept -> bool
+	{
+		return _sources.empty();
+	}
+
+	/// @brief Opens all sources and starts the reactor thread, if there are any sources
+	/// @throw std::system_error if the sources could not be opened
+	auto start() -> void;
+
+	/// @brief Stops the reactor thread, and closes all the sources opened by path
+	auto stop() -> void;
+
+	/// @brief Reads and discards all data that is currently available from a non-blocking file descriptor
+	static auto drain(int fileDescriptor) noexcept -> void;
+
+private:
+	/// @brief A single source
+	struct Source final
+	{
+		/// @brief The path, or an empty path if the source was added as a file descriptor
+		std::filesystem::path _path;
+		/// @brief The file descriptor, or -1 if the source is not open
+		int _fileDescriptor { -1 };
+		/// @brief The handler
+		Handler _handler;
+	};
+
+	/// @brief The thread function
+	auto run(std::stop_token stopToken) -> void;
+
+	/// @brief Handles a hangup or error of a source
+	auto hangUp(std::size_t index, std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Closes the file descriptors
+	auto close() noexcept -> void;
+
+	/// @brief The sources
+	std::vector<Source> _sources;
+
+	/// @brief The epoll file descriptor, or -1
+	int _epoll { -1 };
+	/// @brief The event file descriptor used to wake up the thread when it should stop, or -1
+	int _wakeUp { -1 };
+
+	/// @brief The reactor thread
+	std::jthread _thread;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
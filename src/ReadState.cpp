@@ -2,14 +2,70 @@
 #include "ReadState.hpp"
 
 #include "Attributes.hpp"
+#include "Events.hpp"
+#include "ExecutionTrace.hpp"
+#include "NoAllocationScope.hpp"
 
 #include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/ReadSentinel.hpp>
 #include <xentara/memory/WriteSentinel.hpp>
 #include <xentara/process/EventList.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
 namespace xentara::plugins::templateDriver
 {
 
+namespace
+{
+
+	/// @brief Compares two statistics values, treating two NaN values as equal
+	auto sameStatistic(double left, double right) noexcept -> bool
+	{
+		return left == right || (std::isnan(left) && std::isnan(right));
+	}
+
+	/// @brief Holds the commit lock of a read state, if the lock is in use
+	class CommitGuard final
+	{
+	public:
+		/// @brief Acquires the lock, if it is in use
+		CommitGuard(std::atomic_flag &lock, bool inUse) noexcept : _lock(inUse ? &lock : nullptr)
+		{
+			// The lock is only ever held for a single commit, so we just yield to the holder
+			while (_lock && _lock->test_and_set(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		/// @brief Releases the lock
+		~CommitGuard()
+		{
+			if (_lock)
+			{
+				_lock->clear(std::memory_order_release);
+			}
+		}
+
+		CommitGuard(const CommitGuard &) = delete;
+		auto operator=(const CommitGuard &) -> CommitGuard & = delete;
+
+	private:
+		/// @brief The lock, or nullptr if the lock is not in use
+		std::atomic_flag *_lock;
+	};
+
+} // namespace
+
 template <std::regular DataType>
 auto ReadState<DataType>::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
 {
@@ -18,7 +74,22 @@ auto ReadState<DataType>::forEachAttribute(const model::ForEachAttributeFunction
 		function(model::Attribute::kUpdateTime) ||
 		function(model::Attribute::kChangeTime) ||
 		function(model::Attribute::kQuality) ||
-		function(attributes::kError);
+		function(attributes::kError) ||
+		function(attributes::kStale) ||
+
+		// Handle the statistics attributes, if enabled
+		(_statisticsEnabled && (
+			function(attributes::kMinimum) ||
+			function(attributes::kMaximum) ||
+			function(attributes::kMean) ||
+			function(attributes::kRms) ||
+			function(attributes::kSampleCount))) ||
+
+		// Handle the poll interval attribute, if the polling rate is adaptive
+		(_adaptivePolling && function(attributes::kPollInterval)) ||
+
+		// Handle the alarm state attribute, if there are limits
+		(_limitMonitor && function(attributes::kAlarmState));
 }
 
 template <std::regular DataType>
@@ -26,28 +97,101 @@ auto ReadState<DataType>::forEachEvent(const model::ForEachEventFunction &functi
 {
 	// Handle all the events we support
 	return
-		function(process::Event::kChanged, std::shared_ptr<process::Event>(parent, &_changedEvent));
+		function(process::Event::kChanged, std::shared_ptr<process::Event>(parent, &_changedEvent)) ||
+
+		// Handle the limit events, if there are limits
+		(_limitMonitor && (
+			function(events::kLimitViolated, std::shared_ptr<process::Event>(parent, &_limitViolatedEvent)) ||
+			function(events::kLimitCleared, std::shared_ptr<process::Event>(parent, &_limitClearedEvent))));
 }
 
 template <std::regular DataType>
 auto ReadState<DataType>::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
 {
+	// States in compact form decode the time stamps and the error when they are read
+	if (_compactEncoding)
+	{
+		if (attribute == model::Attribute::kUpdateTime)
+		{
+			return data::ReadHandle { std::in_place_type<std::chrono::system_clock::time_point>, &ReadState::compactUpdateTime, _self };
+		}
+		else if (attribute == model::Attribute::kChangeTime)
+		{
+			return data::ReadHandle { std::in_place_type<std::chrono::system_clock::time_point>, &ReadState::compactChangeTime, _self };
+		}
+		else if (attribute == model::Attribute::kQuality)
+		{
+			return _compactBlock.member(&CompactState::_quality);
+		}
+		else if (attribute == attributes::kError)
+		{
+			return data::ReadHandle { std::in_place_type<std::error_code>, &ReadState::compactError, _self };
+		}
+		else if (attribute == attributes::kStale)
+		{
+			return _compactBlock.member(&CompactState::_stale);
+		}
+
+		return std::nullopt;
+	}
+
 	// Try each readable attribute
 	if (attribute == model::Attribute::kUpdateTime)
 	{
-		return _dataBlock.member(&State::_updateTime);
+		return memberReadHandle<&State::_updateTime>();
 	}
 	else if (attribute == model::Attribute::kChangeTime)
 	{
-		return _dataBlock.member(&State::_changeTime);
+		return memberReadHandle<&State::_changeTime>();
 	}
 	else if (attribute == model::Attribute::kQuality)
 	{
-		return _dataBlock.member(&State::_quality);
+		return memberReadHandle<&State::_quality>();
 	}
 	else if (attribute == attributes::kError)
 	{
-		return _dataBlock.member(&State::_error);
+		return memberReadHandle<&State::_error>();
+	}
+	else if (attribute == attributes::kStale)
+	{
+		return memberReadHandle<&State::_stale>();
+	}
+
+	// Try the statistics attributes, if enabled
+	if (_statisticsEnabled)
+	{
+		if (attribute == attributes::kMinimum)
+		{
+			return _samplingBlock.member(&SamplingState::_minimum);
+		}
+		else if (attribute == attributes::kMaximum)
+		{
+			return _samplingBlock.member(&SamplingState::_maximum);
+		}
+		else if (attribute == attributes::kMean)
+		{
+			return _samplingBlock.member(&SamplingState::_mean);
+		}
+		else if (attribute == attributes::kRms)
+		{
+			return _samplingBlock.member(&SamplingState::_rms);
+		}
+		else if (attribute == attributes::kSampleCount)
+		{
+			return _samplingBlock.member(&SamplingState::_sampleCount);
+		}
+	}
+
+	// Try the poll interval attribute, if the polling rate is adaptive
+	if (_adaptivePolling && attribute == attributes::kPollInterval)
+	{
+		return _samplingBlock.member(&SamplingState::_pollInterval);
+	}
+
+	// Try the alarm state attribute, if there are limits
+	if (_limitMonitor && attribute == attributes::kAlarmState)
+	{
+		return memberReadHandle<&State::_alarmState>();
 	}
 
 	return std::nullopt;
@@ -56,24 +200,247 @@ auto ReadState<DataType>::makeReadHandle(const model::Attribute &attribute) cons
 template <std::regular DataType>
 auto ReadState<DataType>::valueReadHandle() const noexcept -> data::ReadHandle
 {
-	return _dataBlock.member(&State::_value);
+	if (_compactEncoding)
+	{
+		return _compactBlock.member(&CompactState::_value);
+	}
+
+	return memberReadHandle<&State::_value>();
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::realize(std::shared_ptr<const void> parent) -> void
+{
+	// Create the data block for the form the state is stored in. States in a group are stored in the data block of the group.
+	if (_group)
+	{
+		_self = std::shared_ptr<const ReadState>(parent, this);
+	}
+	else if (_compactEncoding)
+	{
+		_compactBlock.create(memory::memoryResources::data());
+		_self = std::shared_ptr<const ReadState>(parent, this);
+	}
+	else
+	{
+		_dataBlock.create(memory::memoryResources::data());
+	}
+
+	// The statistics and the poll interval are stored in a data block of their own, if needed
+	if (_statisticsEnabled || _adaptivePolling)
+	{
+		_samplingBlock.create(memory::memoryResources::data());
+	}
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::enableCompactStorage(CompactEncoding &encoding) -> void
+{
+	// The compact form has no room for the statistics, the poll interval, or the alarm state
+	if (_statisticsEnabled || _adaptivePolling || _limitMonitor)
+	{
+		throw std::runtime_error("compact storage does not support oversampled data points, adaptive polling or limits");
+	}
+	// Groups store their states in a common data block, which has no compact form
+	if (_group)
+	{
+		throw std::runtime_error("template data points in a group cannot be stored in compact form");
+	}
+
+	_compactEncoding = &encoding;
 }
 
 template <std::regular DataType>
-auto ReadState<DataType>::realize() -> void
+template <auto kMember>
+auto ReadState<DataType>::groupMember() const noexcept -> std::remove_cvref_t<decltype(std::declval<State>().*kMember)>
 {
-	// Create the data block
-	_dataBlock.create(memory::memoryResources::data());
+	return _group->inspect([this](std::span<const State> states) { return states[_groupIndex].*kMember; });
 }
 
 template <std::regular DataType>
-auto ReadState<DataType>::update(std::chrono::system_clock::time_point timeStamp, const utils::eh::expected<DataType, std::error_code> &valueOrError) -> void
+template <auto kMember>
+auto ReadState<DataType>::memberReadHandle() const noexcept -> data::ReadHandle
 {
-	// Make a write sentinel
+	// States in a group read their member from the data block of the group
+	if (_group)
+	{
+		using MemberType = std::remove_cvref_t<decltype(std::declval<State>().*kMember)>;
+		return data::ReadHandle { std::in_place_type<MemberType>, &ReadState::groupMember<kMember>, _self };
+	}
+
+	return _dataBlock.member(kMember);
+}
+
+template <std::regular DataType>
+template <typename Function>
+auto ReadState<DataType>::inspect(Function &&function) const -> decltype(auto)
+{
+	if (_group)
+	{
+		return _group->inspect([&](std::span<const State> states) -> decltype(auto) { return function(states[_groupIndex]); });
+	}
+
+	if (_compactEncoding)
+	{
+		memory::ReadSentinel sentinel { _compactBlock };
+		return function(expand(*sentinel));
+	}
+
+	memory::ReadSentinel sentinel { _dataBlock };
+	return function(*sentinel);
+}
+
+template <std::regular DataType>
+template <typename Function>
+auto ReadState<DataType>::modify(std::chrono::system_clock::time_point commitTime, Function &&function) -> void
+{
+	process::StaticEventList<2> events;
+
+	// States in a group are modified within the data block of the group. The states of the other members must be
+	// copied, because memory resources use swap-in.
+	if (_group)
+	{
+		_group->modify(commitTime, events, _pointIndex, [&](std::span<State> states, std::span<const State> oldStates) {
+			std::ranges::copy(oldStates, states.begin());
+			const auto changed = function(states[_groupIndex], oldStates[_groupIndex]);
+			collectEvents(events, changed, states[_groupIndex], oldStates[_groupIndex]);
+		});
+		return;
+	}
+
+	// States in compact form are expanded, modified, and compacted again
+	if (_compactEncoding)
+	{
+		memory::WriteSentinel sentinel { _compactBlock };
+		State state;
+		const auto oldState = expand(sentinel.oldValue());
+		const auto changed = function(state, oldState);
+		collectEvents(events, changed, state, oldState);
+		*sentinel = compact(state);
+
+		const ExecutionTrace::Scope trace { ExecutionTrace::Span::Commit, _pointIndex };
+		sentinel.commit(commitTime, events);
+		return;
+	}
+
+	// Modify states in full form in place
 	memory::WriteSentinel sentinel { _dataBlock };
-	auto &state = *sentinel;
-	const auto &oldState = sentinel.oldValue();
+	const auto changed = function(*sentinel, sentinel.oldValue());
+	collectEvents(events, changed, *sentinel, sentinel.oldValue());
+
+	const ExecutionTrace::Scope trace { ExecutionTrace::Span::Commit, _pointIndex };
+	sentinel.commit(commitTime, events);
+}
 
+template <std::regular DataType>
+template <typename EventList>
+auto ReadState<DataType>::collectEvents(EventList &events, bool changed, const State &state, const State &oldState) -> void
+{
+	if (changed)
+	{
+		events.push_back(_changedEvent);
+	}
+
+	// Raise the limit events if the alarm state changed. Jumping from one side to the other counts as more severe.
+	if (state._alarmState != oldState._alarmState)
+	{
+		const auto moreSevere = std::abs(state._alarmState) > std::abs(oldState._alarmState) ||
+			state._alarmState * oldState._alarmState < 0;
+		events.push_back(moreSevere ? _limitViolatedEvent : _limitClearedEvent);
+	}
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::compact(const State &state) noexcept -> CompactState
+{
+	return {
+		state._value,
+		_compactEncoding->encode(state._updateTime),
+		_compactEncoding->encode(state._changeTime),
+		_compactEncoding->intern(state._error),
+		state._quality,
+		state._stale };
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::expand(const CompactState &state) const noexcept -> State
+{
+	State expanded;
+	expanded._updateTime = _compactEncoding->decode(state._updateTime);
+	expanded._value = state._value;
+	expanded._changeTime = _compactEncoding->decode(state._changeTime);
+	expanded._quality = state._quality;
+	expanded._error = _compactEncoding->error(state._error);
+	expanded._stale = state._stale;
+	return expanded;
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::compactUpdateTime() const noexcept -> std::chrono::system_clock::time_point
+{
+	memory::ReadSentinel sentinel { _compactBlock };
+	return _compactEncoding->decode(sentinel->_updateTime);
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::compactChangeTime() const noexcept -> std::chrono::system_clock::time_point
+{
+	memory::ReadSentinel sentinel { _compactBlock };
+	return _compactEncoding->decode(sentinel->_changeTime);
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::compactError() const noexcept -> std::error_code
+{
+	memory::ReadSentinel sentinel { _compactBlock };
+	return _compactEncoding->error(sentinel->_error);
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::update(std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<DataType, std::error_code> &valueOrError,
+	const SampleStatistics *statistics) -> void
+{
+	// Updating the state must not allocate any memory, as it is done on the cyclic path
+	const NoAllocationScope noAllocation;
+
+	// Don't commit at the same time as other threads
+	const CommitGuard guard { commitLock(), _commitLockEnabled };
+
+	// Adapt the polling rate, if requested
+	if constexpr (std::is_arithmetic_v<DataType>)
+	{
+		if (_adaptivePolling)
+		{
+			if (valueOrError)
+			{
+				_adaptivePolling->observe(timeStamp, double(*valueOrError));
+			}
+			else
+			{
+				_adaptivePolling->observeError(timeStamp);
+			}
+		}
+	}
+
+	// Commit the statistics and the poll interval first, so that they are already in place when the changed event is raised
+	const auto samplingChanged = commitSampling(timeStamp, valueOrError ? statistics : nullptr);
+
+	// Modify the state, and commit it
+	bool changed = false;
+	modify(timeStamp, [&](State &state, const State &oldState) {
+		changed = computeUpdate(state, oldState, timeStamp, valueOrError, samplingChanged);
+		return changed;
+	});
+
+	// Publish the update
+	publishUpdate(timeStamp, valueOrError, changed);
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::computeUpdate(State &state, const State &oldState, std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<DataType, std::error_code> &valueOrError, bool samplingChanged) -> bool
+{
 	state._updateTime = timeStamp;
 
 	// See if we have a value
@@ -97,25 +464,389 @@ auto ReadState<DataType>::update(std::chrono::system_clock::time_point timeStamp
 		state._error = valueOrError.error();
 	}
 
-	// Detect changes
+	// Check the value against the limits, if requested. We always need to write the alarm state, even if there are no
+	// limits, because memory resources use swap-in.
+	state._alarmState = oldState._alarmState;
+	if constexpr (std::is_arithmetic_v<DataType>)
+	{
+		if (_limitMonitor)
+		{
+			// Read errors keep the alarm state
+			if (valueOrError)
+			{
+				state._alarmState = _limitMonitor->evaluate(timeStamp, double(state._value), oldState._alarmState);
+			}
+			else
+			{
+				_limitMonitor->observeError();
+			}
+		}
+	}
+
+	// Detect changes to the data
 	const auto valueChanged = state._value != oldState._value;
 	const auto qualityChanged = state._quality != oldState._quality;
 	const auto errorChanged = state._error != oldState._error;
-	const auto changed = valueChanged || qualityChanged || errorChanged;
+	const auto alarmStateChanged = state._alarmState != oldState._alarmState;
+
+	// The data is current again
+	state._stale = false;
+
+	// Detect changes
+	const auto changed = valueChanged || qualityChanged || errorChanged || samplingChanged || alarmStateChanged || oldState._stale;
 
 	// Update the change time, if necessary. We always need to write the change time, even if it is the same as before,
 	// because memory resources use swap-in.
 	state._changeTime = changed ? timeStamp : oldState._changeTime;
 
-	// Collect the events to raise
-	process::StaticEventList<1> events;
-	if (changed)
+	return changed;
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::commitSampling(std::chrono::system_clock::time_point timeStamp, const SampleStatistics *statistics) -> bool
+{
+	// Nothing to do if neither the statistics nor the poll interval are enabled
+	if (!_statisticsEnabled && !_adaptivePolling)
 	{
-		events.push_back(_changedEvent);
+		return false;
+	}
+
+	memory::WriteSentinel sentinel { _samplingBlock };
+	auto &state = *sentinel;
+	const auto &oldState = sentinel.oldValue();
+
+	// Set the statistics. We always need to write these, even if they are not enabled, because memory resources use swap-in.
+	if (_statisticsEnabled && statistics)
+	{
+		state._minimum = statistics->minimum();
+		state._maximum = statistics->maximum();
+		state._mean = statistics->mean();
+		state._rms = statistics->rms();
+		state._sampleCount = statistics->count();
+	}
+	else
+	{
+		state._minimum = state._maximum = state._mean = state._rms = std::numeric_limits<double>::quiet_NaN();
+		state._sampleCount = 0;
+	}
+
+	// Publish the current poll interval. We always need to write the interval, even if the polling rate is fixed,
+	// because memory resources use swap-in.
+	state._pollInterval = _adaptivePolling ? std::uint64_t(_adaptivePolling->interval().count()) : 0;
+
+	// Detect changes
+	const auto changed = state._sampleCount != oldState._sampleCount ||
+		!sameStatistic(state._minimum, oldState._minimum) ||
+		!sameStatistic(state._maximum, oldState._maximum) ||
+		!sameStatistic(state._mean, oldState._mean) ||
+		!sameStatistic(state._rms, oldState._rms) ||
+		state._pollInterval != oldState._pollInterval;
+
+	// Commit the data without raising any events. The changed event is raised by the commit of the state itself.
+	sentinel.commit(timeStamp, process::StaticEventList<1> {});
+
+	return changed;
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::publishUpdate(std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<DataType, std::error_code> &valueOrError, bool changed) -> void
+{
+	// Record the value in the history, if any. Only valid values are recorded.
+	if constexpr (std::is_arithmetic_v<DataType>)
+	{
+		if (_history && valueOrError)
+		{
+			_history->append(timeStamp, double(*valueOrError));
+		}
+	}
+
+	// Publish the change to the journal, if any. This is done after the commit, so that anyone following the
+	// journal will find the new data already in place.
+	if (changed && _journal)
+	{
+		_journal->append(_pointIndex, timeStamp, valueOrError ? *valueOrError : DataType {},
+			valueOrError ? data::Quality::Good : data::Quality::Bad);
+	}
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::markStale(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Don't commit at the same time as other threads
+	const CommitGuard guard { commitLock(), _commitLockEnabled };
+
+	// Nothing to do if the data is already marked as stale
+	if (inspect([](const State &state) { return state._stale; }))
+	{
+		return;
+	}
+
+	// Keep everything as it was, but mark the data as stale, and raise the changed event. We need to copy everything,
+	// because memory resources use swap-in.
+	DataType value {};
+	auto quality = data::Quality::Bad;
+	modify(timeStamp, [&](State &state, const State &oldState) {
+		state = oldState;
+		state._stale = true;
+		state._changeTime = timeStamp;
+		value = state._value;
+		quality = state._quality;
+		return true;
+	});
+
+	// Publish the change to the journal, if any
+	if (_journal)
+	{
+		_journal->append(_pointIndex, timeStamp, value, quality);
+	}
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::checkUpdateTimeout(std::chrono::system_clock::time_point now) -> std::chrono::system_clock::time_point
+{
+	// Don't commit at the same time as other threads
+	const CommitGuard guard { commitLock(), true };
+
+	// Check if the value has timed out. This only needs a read sentinel, because no one else can commit while we hold the lock.
+	const auto recheckTime = inspect([&](const State &state) -> std::optional<std::chrono::system_clock::time_point> {
+		// If the value was updated in the meantime, check again when the new value would time out
+		const auto deadline = state._updateTime + _updateTimeout;
+		if (deadline > now)
+		{
+			return deadline;
+		}
+
+		// Leave invalid values, and values that have already timed out, alone
+		if (state._quality == data::Quality::Bad || state._error == CustomError::UpdateTimeout)
+		{
+			return now + _updateTimeout;
+		}
+
+		return std::nullopt;
+	});
+	if (recheckTime)
+	{
+		return *recheckTime;
+	}
+
+	// Keep everything as it was, but downgrade the quality, and raise the changed event. We need to copy everything,
+	// because memory resources use swap-in.
+	DataType value {};
+	modify(now, [&](State &state, const State &oldState) {
+		state = oldState;
+		state._quality = _timeoutQuality;
+		state._error = CustomError::UpdateTimeout;
+		state._changeTime = now;
+		value = state._value;
+		return true;
+	});
+
+	// Publish the change to the journal, if any
+	if (_journal)
+	{
+		_journal->append(_pointIndex, now, value, _timeoutQuality);
+	}
+
+	// Check again after another timeout, to pick up the next update
+	return now + _updateTimeout;
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::invalidate(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Skip data that was never read, or that was already invalidated. This saves a commit for each such point.
+	if (inspect([](const State &state) { return state._error == CustomError::NoData; }))
+	{
+		return;
+	}
+
+	// Set the state to "No Data"
+	update(timeStamp, utils::eh::unexpected(CustomError::NoData));
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::markDisconnected(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Skip data that is already marked. This saves a commit for each read while the connection is down.
+	if (inspect([](const State &state) { return state._error == CustomError::NotConnected; }))
+	{
+		return;
+	}
+
+	// Set the state to "Not Connected"
+	update(timeStamp, utils::eh::unexpected(CustomError::NotConnected));
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::restore(std::chrono::system_clock::time_point timeStamp, const DataType &value) -> void
+{
+	// Don't commit at the same time as other threads
+	const CommitGuard guard { commitLock(), _commitLockEnabled };
+
+	// Clear the statistics, if any
+	const auto commitTime = std::chrono::system_clock::now();
+	commitSampling(commitTime, nullptr);
+
+	// Publish the value with its original time stamps, but mark it as not yet confirmed, and raise the changed event. The
+	// limits are only checked once the value is read.
+	modify(commitTime, [&](State &state, const State &) {
+		state._updateTime = timeStamp;
+		state._changeTime = timeStamp;
+		state._value = value;
+		state._quality = data::Quality::Uncertain;
+		state._error = CustomError::RestoredValue;
+		state._alarmState = 0;
+		state._stale = false;
+		return true;
+	});
+
+	// Publish the change to the journal, if any
+	if (_journal)
+	{
+		_journal->append(_pointIndex, timeStamp, value, data::Quality::Uncertain);
+	}
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::currentValue() const -> std::optional<std::pair<std::chrono::system_clock::time_point, DataType>>
+{
+	return inspect([](const State &state) -> std::optional<std::pair<std::chrono::system_clock::time_point, DataType>> {
+		// Only return valid values
+		if (state._quality == data::Quality::Bad)
+		{
+			return std::nullopt;
+		}
+
+		return std::pair { state._updateTime, state._value };
+	});
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::Group::add(ReadState &state) -> void
+{
+	// Check that the state can be added
+	if (_realized)
+	{
+		throw std::logic_error("template data points cannot be added to a group that was already realized");
+	}
+	if (_members.size() == kMaxSize)
+	{
+		throw std::runtime_error("group of template data points has more than 32 data points");
+	}
+	if (state._compactEncoding)
+	{
+		throw std::runtime_error("template data points in a group cannot be stored in compact form");
 	}
 
-	// Commit the data and raise the events
-	sentinel.commit(timeStamp, events);
+	// States in a group are committed from different threads, so they always use the lock of the group
+	state._group = this;
+	state._groupIndex = _members.size();
+	state._commitLockEnabled = true;
+	_members.push_back(&state);
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::Group::realize() -> void
+{
+	_realized = true;
+
+	// Create the smallest data block that has room for all the states
+	switch (std::bit_ceil(_members.size()))
+	{
+	case 1:
+		createDataBlock<1>();
+		break;
+	case 2:
+		createDataBlock<2>();
+		break;
+	case 4:
+		createDataBlock<4>();
+		break;
+	case 8:
+		createDataBlock<8>();
+		break;
+	case 16:
+		createDataBlock<16>();
+		break;
+	default:
+		createDataBlock<kMaxSize>();
+		break;
+	}
+}
+
+template <std::regular DataType>
+template <std::size_t kCapacity>
+auto ReadState<DataType>::Group::createDataBlock() -> void
+{
+	_dataBlock.template emplace<memory::ObjectBlock<GroupState<kCapacity>>>().create(memory::memoryResources::data());
+}
+
+template <std::regular DataType>
+template <typename Function>
+auto ReadState<DataType>::Group::inspect(Function &&function) const -> decltype(auto)
+{
+	return std::visit([&](const auto &dataBlock) -> decltype(auto) {
+		memory::ReadSentinel sentinel { dataBlock };
+		return function(std::span<const State>((*sentinel)._states).first(_members.size()));
+	}, _dataBlock);
+}
+
+template <std::regular DataType>
+template <typename EventList, typename Function>
+auto ReadState<DataType>::Group::modify(std::chrono::system_clock::time_point commitTime, EventList &events, std::size_t pointIndex,
+	Function &&function) -> void
+{
+	std::visit([&](auto &dataBlock) {
+		memory::WriteSentinel sentinel { dataBlock };
+		function(std::span<State>((*sentinel)._states).first(_members.size()),
+			std::span<const State>(sentinel.oldValue()._states).first(_members.size()));
+
+		const ExecutionTrace::Scope trace { ExecutionTrace::Span::Commit, pointIndex };
+		sentinel.commit(commitTime, events);
+	}, _dataBlock);
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::Group::update(std::chrono::system_clock::time_point timeStamp, std::span<const DataType> values) -> void
+{
+	commit(timeStamp, [&](std::size_t index) -> utils::eh::expected<DataType, std::error_code> { return values[index]; });
+}
+
+template <std::regular DataType>
+auto ReadState<DataType>::Group::update(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void
+{
+	commit(timeStamp, [&](std::size_t) -> utils::eh::expected<DataType, std::error_code> { return utils::eh::unexpected(error); });
+}
+
+template <std::regular DataType>
+template <typename ValueFunction>
+auto ReadState<DataType>::Group::commit(std::chrono::system_clock::time_point timeStamp, ValueFunction &&valueOf) -> void
+{
+	// Updating the states must not allocate any memory, as it is done on the cyclic path
+	const NoAllocationScope noAllocation;
+
+	// Don't commit at the same time as other threads
+	const CommitGuard guard { _commitLock, true };
+
+	// Compute the new states, and collect the events of the states that changed. Each state can raise the changed event
+	// and a limit event. All the states are committed at once, so that consumers always see a consistent snapshot.
+	std::array<bool, kMaxSize> changed {};
+	process::StaticEventList<kMaxSize * 2> events;
+	modify(timeStamp, events, _members.front()->_pointIndex, [&](std::span<State> states, std::span<const State> oldStates) {
+		for (std::size_t index = 0; index < _members.size(); ++index)
+		{
+			auto &member = *_members[index];
+			changed[index] = member.computeUpdate(states[index], oldStates[index], timeStamp, valueOf(index), false);
+			member.collectEvents(events, changed[index], states[index], oldStates[index]);
+		}
+	});
+
+	// Publish the updates
+	for (std::size_t index = 0; index < _members.size(); ++index)
+	{
+		_members[index]->publishUpdate(timeStamp, valueOf(index), changed[index]);
+	}
 }
 
 /// @class xentara::plugins::templateDriver::ReadState
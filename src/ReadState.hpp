@@ -1,8 +1,14 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "AdaptivePolling.hpp"
 #include "Attributes.hpp"
+#include "ChangeJournal.hpp"
+#include "CompactEncoding.hpp"
+#include "CompressedHistory.hpp"
 #include "CustomError.hpp"
+#include "LimitMonitor.hpp"
+#include "SampleStatistics.hpp"
 
 #include <xentara/data/Quality.hpp>
 #include <xentara/data/ReadHandle.hpp>
@@ -12,10 +18,20 @@
 #include <xentara/process/Event.hpp>
 #include <xentara/utils/eh/expected.hpp>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace xentara::plugins::templateDriver
 {
@@ -25,6 +41,8 @@ template <std::regular DataType>
 class ReadState final
 {
 public:
+	class Group;
+
 	/// @brief Iterates over all the attributes that belong to this state.
 	/// @param function The function that should be called for each attribute
 	/// @return The return value of the last function call
@@ -53,13 +71,150 @@ public:
 	auto valueReadHandle() const noexcept -> data::ReadHandle;
 
 	/// @brief Realizes the state
-	auto realize() -> void;
+	/// @param parent
+	/// @parblock
+	/// A shared pointer to the containing object.
+	///
+	/// The pointer is used in the aliasing constructor of std::shared_ptr when constructing the read handles of a state
+	/// in compact storage, so that they will share ownership information with pointers to the parent object.
+	/// @endparblock
+	auto realize(std::shared_ptr<const void> parent) -> void;
+
+	/// @brief Stores the state in compact form, to save memory when there are very many data points
+	///
+	/// The state publishes the same attributes as in full form, except for the statistics and the poll interval. The
+	/// time stamps are stored with a resolution of one microsecond, and are read through the encoding, like the error.
+	/// This must be called before realize().
+	/// @param encoding The encoding of the time stamps and errors, which is shared by all data points of an I/O component
+	/// @throw std::runtime_error The state is in a group, or the statistics, the adaptive polling rate, or the limits are
+	/// enabled, which are not supported
+	auto enableCompactStorage(CompactEncoding &encoding) -> void;
+
+	/// @brief Sets the index of the data point within its I/O component, which is used in journal entries and traces
+	auto setPointIndex(std::size_t pointIndex) noexcept -> void
+	{
+		_pointIndex = pointIndex;
+	}
+
+	/// @brief Attaches a change journal that all changes to the state will be published to
+	/// @param journal The journal
+	auto attachJournal(ChangeJournal<DataType> &journal) noexcept -> void
+	{
+		_journal = &journal;
+	}
+
+	/// @brief Enables the attributes containing the statistics of oversampled values
+	auto enableStatistics() noexcept -> void
+	{
+		_statisticsEnabled = true;
+	}
+
+	/// @brief Attaches an object that adapts the polling rate to the changes of the value.
+	///
+	/// The object is fed with each update, and its current interval is published as an attribute.
+	/// @param polling The object
+	auto attachAdaptivePolling(AdaptivePolling &polling) noexcept -> void
+	{
+		_adaptivePolling = &polling;
+	}
+
+	/// @brief Attaches an object that checks the value against alarm limits.
+	///
+	/// The object is fed with each update, and the resulting alarm state is published as an attribute, and committed
+	/// together with the value. Changes to the alarm state raise the limit events.
+	/// @param monitor The object
+	auto attachLimitMonitor(LimitMonitor &monitor) noexcept -> void
+	{
+		_limitMonitor = &monitor;
+	}
+
+	/// @brief Enables the update timeout
+	/// @param timeout The maximum time between two updates before the quality of the value is downgraded
+	/// @param quality The quality the value is downgraded to
+	auto enableUpdateTimeout(std::chrono::nanoseconds timeout, data::Quality quality) noexcept -> void
+	{
+		_updateTimeout = timeout;
+		_timeoutQuality = quality;
+		_commitLockEnabled = true;
+	}
+
+	/// @brief Allows the state to be updated from more than one thread, e.g. from the "read" task and from the reactor
+	auto enableConcurrentUpdates() noexcept -> void
+	{
+		_commitLockEnabled = true;
+	}
+
+	/// @brief Returns the group the state belongs to, or nullptr if the state is committed on its own
+	auto group() const noexcept -> const Group *
+	{
+		return _group;
+	}
+
+	/// @brief Returns the update timeout, or zero if the update timeout is not enabled
+	auto updateTimeout() const noexcept -> std::chrono::nanoseconds
+	{
+		return _updateTimeout;
+	}
+
+	/// @brief Restores a value that was saved during an earlier run.
+	///
+	/// The value is published with the original time stamp, but with uncertain quality, until it is read for the first time.
+	/// @param timeStamp The original update time stamp of the value
+	/// @param value The value
+	auto restore(std::chrono::system_clock::time_point timeStamp, const DataType &value) -> void;
+
+	/// @brief Returns the current value and its update time stamp, or std::nullopt if the value is not valid
+	auto currentValue() const -> std::optional<std::pair<std::chrono::system_clock::time_point, DataType>>;
+
+	/// @brief Enables the in-memory history of the value
+	/// @param blockCount The number of compressed blocks to keep. See CompressedHistory for details.
+	auto enableHistory(std::size_t blockCount) -> void
+	{
+		_history = std::make_unique<CompressedHistory>(blockCount);
+	}
+
+	/// @brief Returns the in-memory history of the value, or nullptr if it is not enabled
+	auto history() const noexcept -> const CompressedHistory *
+	{
+		return _history.get();
+	}
 
 	/// @brief Updates the data and sends events
 	/// @param timeStamp The update time stamp
 	/// @param valueOrError This is a variant-like type that will hold either the new value, or an std::error_code object
 	/// containing an read error
-	auto update(std::chrono::system_clock::time_point timeStamp, const utils::eh::expected<DataType, std::error_code> &valueOrError) -> void;
+	/// @param statistics The statistics of all the samples taken since the last update, or nullptr if the value was only
+	/// sampled once. This is ignored if the statistics were not enabled using enableStatistics().
+	auto update(std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<DataType, std::error_code> &valueOrError,
+		const SampleStatistics *statistics = nullptr) -> void;
+
+	/// @brief Marks the data as stale, because a read was deferred, and sends events
+	///
+	/// The data is marked as current again on the next update. If the data is already marked as stale, nothing is
+	/// committed, and no events are sent.
+	/// @param timeStamp The time stamp of the deferred read
+	auto markStale(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Downgrades the quality of the value if it was not updated within the update timeout, and sends events
+	///
+	/// The value itself is kept. The quality is restored on the next update. Values that already have bad quality, or
+	/// that have already been downgraded, are left alone.
+	/// @param now The current time, which is also used as time stamp for the commit
+	/// @return The time at which the value should be checked again
+	auto checkUpdateTimeout(std::chrono::system_clock::time_point now) -> std::chrono::system_clock::time_point;
+
+	/// @brief Sets the data to "No Data" and sends events
+	///
+	/// If the data is already in the "No Data" state, nothing is committed, and no events are sent.
+	/// @param timeStamp The update time stamp
+	auto invalidate(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Sets the data to an error because the I/O component lost its connection, and sends events
+	///
+	/// If the data is already marked as not connected, nothing is committed, and no events are sent.
+	/// @param timeStamp The update time stamp
+	auto markDisconnected(std::chrono::system_clock::time_point timeStamp) -> void;
 
 private:
 	/// @brief This structure is used to represent the state inside the memory block
@@ -75,15 +230,275 @@ private:
 		data::Quality _quality { data::Quality::Bad };
 		/// @brief The error code when reading the value, or a default constructed std::error_code object for none.
 		std::error_code _error { CustomError::NoData };
+		/// @brief The alarm state, if the value is checked against limits. See LimitMonitor for the meaning of the values.
+		std::int8_t _alarmState { 0 };
+		/// @brief Whether the value is stale, because reads were deferred to keep the cycle within its budget
+		bool _stale { false };
 	};
 
+	/// @brief This structure is used to represent the statistics and the poll interval inside their own memory block
+	///
+	/// These are kept out of State, so that data points that are neither oversampled nor polled adaptively don't have to
+	/// store them, and don't have to copy them on every commit.
+	struct SamplingState final
+	{
+		/// @brief The smallest sample of the last sampling interval
+		double _minimum { std::numeric_limits<double>::quiet_NaN() };
+		/// @brief The largest sample of the last sampling interval
+		double _maximum { std::numeric_limits<double>::quiet_NaN() };
+		/// @brief The mean of the samples of the last sampling interval
+		double _mean { std::numeric_limits<double>::quiet_NaN() };
+		/// @brief The root mean square of the samples of the last sampling interval
+		double _rms { std::numeric_limits<double>::quiet_NaN() };
+		/// @brief The number of samples taken in the last sampling interval
+		std::uint64_t _sampleCount { 0 };
+		/// @brief The current interval between reads in nanoseconds, if the polling rate is adaptive
+		std::uint64_t _pollInterval { 0 };
+	};
+
+	/// @brief This structure is used to represent the state inside the memory block in compact form
+	///
+	/// This holds the same information as State, except for the alarm state. With a value of type double, it takes 24
+	/// bytes instead of 56.
+	struct CompactState final
+	{
+		/// @brief The current value
+		DataType _value {};
+		/// @brief The update time stamp
+		CompactEncoding::TimeStamp _updateTime { CompactEncoding::kNever };
+		/// @brief The change time stamp
+		CompactEncoding::TimeStamp _changeTime { CompactEncoding::kNever };
+		/// @brief The index of the error code
+		CompactEncoding::ErrorIndex _error { CompactEncoding::kNoData };
+		/// @brief The quality of the value
+		data::Quality _quality { data::Quality::Bad };
+		/// @brief Whether the value is stale
+		bool _stale { false };
+	};
+
+	/// @brief Returns the lock that serializes commits of the data block the state is stored in
+	auto commitLock() noexcept -> std::atomic_flag &;
+
+	/// @brief Computes a new state from the old state when the data is updated
+	/// @param samplingChanged Whether the statistics or the poll interval changed, which counts as a change of the state
+	/// @return Whether anything changed
+	auto computeUpdate(State &state, const State &oldState, std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<DataType, std::error_code> &valueOrError, bool samplingChanged) -> bool;
+
+	/// @brief Commits the statistics and the poll interval, if either is enabled
+	/// @param timeStamp The time stamp of the commit
+	/// @param statistics The statistics, or nullptr to clear them
+	/// @return Whether the statistics or the poll interval changed
+	auto commitSampling(std::chrono::system_clock::time_point timeStamp, const SampleStatistics *statistics) -> bool;
+
+	/// @brief Collects the events to raise for a new state
+	/// @param events The event list to add the events to. Must have room for two events.
+	/// @param changed Whether the changed event should be raised
+	template <typename EventList>
+	auto collectEvents(EventList &events, bool changed, const State &state, const State &oldState) -> void;
+
+	/// @brief Publishes an update to the history and the change journal, once it has been committed
+	auto publishUpdate(std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<DataType, std::error_code> &valueOrError, bool changed) -> void;
+
+	/// @brief Returns a member of the state within the data block of its group. This is used for the read handles.
+	template <auto kMember>
+	auto groupMember() const noexcept -> std::remove_cvref_t<decltype(std::declval<State>().*kMember)>;
+
+	/// @brief Creates a read handle for a member of the state
+	template <auto kMember>
+	auto memberReadHandle() const noexcept -> data::ReadHandle;
+
+	/// @brief Calls a function with the current state, expanding it first if it is stored in compact form
+	template <typename Function>
+	auto inspect(Function &&function) const -> decltype(auto);
+
+	/// @brief Modifies the state, and commits it
+	/// @param commitTime The time stamp of the commit
+	/// @param function A function that will be called with the new state and the old state. The function must fill in
+	/// all members of the new state, and return whether the changed event should be raised.
+	template <typename Function>
+	auto modify(std::chrono::system_clock::time_point commitTime, Function &&function) -> void;
+
+	/// @brief Converts a state into compact form
+	auto compact(const State &state) noexcept -> CompactState;
+	/// @brief Expands a state from compact form
+	auto expand(const CompactState &state) const noexcept -> State;
+
+	/// @brief Returns the update time stamp of a state in compact form. This is used for the read handle.
+	auto compactUpdateTime() const noexcept -> std::chrono::system_clock::time_point;
+	/// @brief Returns the change time stamp of a state in compact form. This is used for the read handle.
+	auto compactChangeTime() const noexcept -> std::chrono::system_clock::time_point;
+	/// @brief Returns the error of a state in compact form. This is used for the read handle.
+	auto compactError() const noexcept -> std::error_code;
+
 	/// @brief A summary event that is raised when anything changes
 	process::Event _changedEvent { io::Direction::Input };
+	/// @brief An event that is raised when the alarm state becomes more severe
+	process::Event _limitViolatedEvent { io::Direction::Input };
+	/// @brief An event that is raised when the alarm state becomes less severe
+	process::Event _limitClearedEvent { io::Direction::Input };
 
-	/// @brief The data block that contains the state
+	/// @brief The data block that contains the state, unless it is stored in compact form
 	memory::ObjectBlock<State> _dataBlock;
+	/// @brief The data block that contains the state in compact form, if enabled
+	memory::ObjectBlock<CompactState> _compactBlock;
+	/// @brief The data block that contains the statistics and the poll interval, if either is enabled
+	memory::ObjectBlock<SamplingState> _samplingBlock;
+	/// @brief The encoding of the state in compact form, or nullptr if the state is stored in full
+	CompactEncoding *_compactEncoding { nullptr };
+	/// @brief The group the state is stored and committed in, or nullptr if it is stored on its own
+	Group *_group { nullptr };
+	/// @brief The index of the state within its group
+	std::size_t _groupIndex { 0 };
+	/// @brief A pointer to ourselves that shares ownership information with the parent object, used for read handles
+	std::weak_ptr<const ReadState> _self;
+
+	/// @brief The maximum time between two updates, or zero if the values never time out
+	std::chrono::nanoseconds _updateTimeout { std::chrono::nanoseconds::zero() };
+	/// @brief The quality that values that have timed out are downgraded to
+	data::Quality _timeoutQuality { data::Quality::Uncertain };
+	/// @brief A lock that serializes commits from different threads, e.g. from the read task and the update timeout
+	std::atomic_flag _commitLock;
+	/// @brief Whether commits need to take the commit lock
+	bool _commitLockEnabled { false };
+
+	/// @brief Whether the statistics attributes are enabled
+	bool _statisticsEnabled { false };
+
+	/// @brief The object that adapts the polling rate, or nullptr if the polling rate is fixed
+	AdaptivePolling *_adaptivePolling { nullptr };
+
+	/// @brief The object that checks the value against alarm limits, or nullptr if there are no limits
+	LimitMonitor *_limitMonitor { nullptr };
+
+	/// @brief The in-memory history of the value, if enabled
+	std::unique_ptr<CompressedHistory> _history;
+
+	/// @brief The change journal changes are published to, or nullptr if there is none
+	ChangeJournal<DataType> *_journal { nullptr };
+	/// @brief The index of the data point within its I/O component
+	std::size_t _pointIndex { 0 };
 };
 
+/// @brief A group of read states that are stored in a common data block, and committed together
+///
+/// Data points whose values are read in a single device transaction, like the phases of a power meter, can be grouped,
+/// so that consumers always see a consistent snapshot of all of them. Updates of the whole group are committed using
+/// a single write sentinel, so the group pays for one commit instead of one per data point. Changes to individual
+/// states, like update timeouts, are committed to the common data block as well.
+template <std::regular DataType>
+class ReadState<DataType>::Group final
+{
+public:
+	/// @brief The maximum number of states in a group
+	static constexpr std::size_t kMaxSize = 32;
+
+	/// @brief Adds a state to the group
+	///
+	/// This must be called before the state and the group are realized.
+	/// @throw std::runtime_error The group is full, or the state is stored in compact form
+	/// @throw std::logic_error The group has already been realized
+	auto add(ReadState &state) -> void;
+
+	/// @brief Realizes the group, once all the states have been added
+	///
+	/// This creates the data block, which is sized for the states added so far, so no states can be added afterwards.
+	auto realize() -> void;
+
+	/// @brief Returns the number of states in the group
+	auto size() const noexcept -> std::size_t
+	{
+		return _members.size();
+	}
+
+	/// @brief Returns the first state of the group, or nullptr if the group is empty
+	auto leader() const noexcept -> const ReadState *
+	{
+		return _members.empty() ? nullptr : _members.front();
+	}
+
+	/// @brief Returns the point index of a state in the group
+	/// @param index The index of the state within the group
+	auto pointIndex(std::size_t index) const noexcept -> std::size_t
+	{
+		return _members[index]->_pointIndex;
+	}
+
+	/// @brief Updates the values of all the states in a single commit, and sends events
+	/// @param timeStamp The update time stamp
+	/// @param values The new values, in the order the states were added. Must contain one value for each state.
+	auto update(std::chrono::system_clock::time_point timeStamp, std::span<const DataType> values) -> void;
+
+	/// @brief Sets all the states to an error in a single commit, and sends events
+	/// @param timeStamp The update time stamp
+	/// @param error The error
+	auto update(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void;
+
+private:
+	/// @brief The states need access to the data block and the lock
+	friend class ReadState;
+
+	/// @brief This structure is used to represent the states of the group inside the memory block
+	/// @tparam kCapacity The number of states the block has room for
+	template <std::size_t kCapacity>
+	struct GroupState final
+	{
+		/// @brief The states, in the order they were added
+		std::array<State, kCapacity> _states;
+	};
+
+	/// @brief The data blocks for groups of up to 1, 2, 4, 8, 16, and 32 states.
+	///
+	/// The whole block is copied on every commit, so the group uses the smallest block that has room for all of its
+	/// states, instead of one with room for kMaxSize states.
+	using DataBlock = std::variant<
+		memory::ObjectBlock<GroupState<1>>,
+		memory::ObjectBlock<GroupState<2>>,
+		memory::ObjectBlock<GroupState<4>>,
+		memory::ObjectBlock<GroupState<8>>,
+		memory::ObjectBlock<GroupState<16>>,
+		memory::ObjectBlock<GroupState<kMaxSize>>>;
+
+	/// @brief Creates a data block with room for a certain number of states
+	template <std::size_t kCapacity>
+	auto createDataBlock() -> void;
+
+	/// @brief Calls a function with the states of all members
+	/// @param function A function that will be called with the states, as std::span<const State>
+	template <typename Function>
+	auto inspect(Function &&function) const -> decltype(auto);
+
+	/// @brief Modifies the states of all members, and commits them
+	/// @param commitTime The time stamp of the commit
+	/// @param events The events to raise. These may be added by the function.
+	/// @param pointIndex The index of the data point to record the commit for in the execution trace
+	/// @param function A function that will be called with the new states, as std::span<State>, and the old states, as
+	/// std::span<const State>. The function must fill in all the new states.
+	template <typename EventList, typename Function>
+	auto modify(std::chrono::system_clock::time_point commitTime, EventList &events, std::size_t pointIndex, Function &&function) -> void;
+
+	/// @brief Computes all the states from their values, and commits them
+	template <typename ValueFunction>
+	auto commit(std::chrono::system_clock::time_point timeStamp, ValueFunction &&valueOf) -> void;
+
+	/// @brief The states in the group
+	std::vector<ReadState *> _members;
+
+	/// @brief The data block that contains the states. This is created by realize().
+	DataBlock _dataBlock;
+	/// @brief Whether realize() was already called
+	bool _realized { false };
+	/// @brief A lock that serializes commits to the data block
+	std::atomic_flag _commitLock;
+};
+
+template <std::regular DataType>
+inline auto ReadState<DataType>::commitLock() noexcept -> std::atomic_flag &
+{
+	return _group ? _group->_commitLock : _commitLock;
+}
+
 /// @class xentara::plugins::templateDriver::ReadState
 /// @todo add extern template statements for other supported types
 extern template class ReadState<double>;
@@ -1,6 +1,10 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "Attributes.hpp"
+#include "NoAllocationScope.hpp"
+#include "TaskTiming.hpp"
+
 #include <xentara/process/Task.hpp>
 #include <xentara/process/ExecutionContext.hpp>
 
@@ -42,20 +46,43 @@ public:
 		
 	/// @}
 
+	/// @brief Returns the timing information of the task
+	auto timing() noexcept -> TaskTiming &
+	{
+		return _timing;
+	}
+
+	/// @brief Returns the timing information of the task
+	auto timing() const noexcept -> const TaskTiming &
+	{
+		return _timing;
+	}
+
 private:
+	/// @brief The attributes the timing information is published under
+	static constexpr TaskTiming::AttributeSet kTimingAttributes {
+		&attributes::kReadStartDelayP99,
+		&attributes::kReadStartDelayMax,
+		&attributes::kReadExecutionTimeP99,
+		&attributes::kReadExecutionTimeMax,
+		&attributes::kReadOverruns };
+
 	/// @brief A reference to the target element
 	std::reference_wrapper<Target> _target;
+
+	/// @brief The timing information
+	TaskTiming _timing { kTimingAttributes };
 };
 
 template <typename Target>
 auto ReadTask<Target>::preparePreOperational(const process::ExecutionContext &context) -> Status
 {
-	// Read the value once to initialize it
-	operational(context);
-
-	// We are done now. Even if we couldn't read the value, we proceed to the next stage,
+	// Read the value once to initialize it. The I/O component may perform the read asynchronously, in which case
+	// we wait until it completes, or until the startup deadline expires.
+	//
+	// Once the read is done, we proceed to the next stage even if we couldn't read the value,
 	// because attempting again is unlikely to succeed any better.
-	return Status::Ready;
+	return _target.get().prepareInitialRead(context) ? Status::Ready : Status::NotReady;
 }
 
 template <typename Target>
@@ -70,7 +97,11 @@ auto ReadTask<Target>::preOperational(const process::ExecutionContext &context)
 template <typename Target>
 auto ReadTask<Target>::operational(const process::ExecutionContext &context) -> void
 {
-	_target.get().performReadTask(context);
+	// The cyclic path must not allocate any memory
+	const NoAllocationScope noAllocation;
+
+	// Measure the timing of the task
+	_timing.measure(context, [&]() { _target.get().performReadTask(context); });
 }
 
 template <typename Target>
@@ -0,0 +1,57 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Determines how long to wait between attempts to reconnect to a device.
+///
+/// The delay starts out at an initial value, and doubles after each failed attempt, up to a maximum. Each delay is
+/// jittered randomly between half and all of its nominal value, so that several clients that lost their connections
+/// at the same time, e.g. because the device restarted, do not all try to reconnect at the same instant.
+class ReconnectBackoff final
+{
+public:
+	/// @brief Creates an object with an initial and a maximum delay
+	/// @param initialDelay The delay before the first attempt to reconnect
+	/// @param maximumDelay The longest delay between attempts
+	ReconnectBackoff(std::chrono::nanoseconds initialDelay, std::chrono::nanoseconds maximumDelay) noexcept :
+		_initialDelay(initialDelay),
+		_maximumDelay(std::max(maximumDelay, initialDelay)),
+		_delay(initialDelay)
+	{
+	}
+
+	/// @brief Returns the time to wait before the next attempt, and backs off for the attempt after that
+	auto next() -> std::chrono::nanoseconds
+	{
+		// Each thread has its own generator, so clients running on different threads get different jitter
+		thread_local std::minstd_rand generator { std::random_device {}() };
+
+		const auto nominal = _delay;
+		_delay = std::min(_delay * 2, _maximumDelay);
+
+		std::uniform_int_distribution<std::chrono::nanoseconds::rep> jitter { nominal.count() / 2, nominal.count() };
+		return std::chrono::nanoseconds(jitter(generator));
+	}
+
+	/// @brief Starts over with the initial delay, after a connection was established
+	auto reset() noexcept -> void
+	{
+		_delay = _initialDelay;
+	}
+
+private:
+	/// @brief The delay before the first attempt
+	std::chrono::nanoseconds _initialDelay;
+	/// @brief The longest delay between attempts
+	std::chrono::nanoseconds _maximumDelay;
+	/// @brief The nominal delay before the next attempt
+	std::chrono::nanoseconds _delay;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,235 @@
+// Copyright (c) embedded ocean GmbH
+#include "RegisterImage.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#	include <immintrin.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+namespace
+{
+
+	/// @brief Converts registers one at a time, and collects the ones that changed
+	/// @return Whether any register changed
+	template <bool kSwap>
+	auto convertScalar(const std::byte *raw, const std::uint16_t *current, std::uint16_t *next, std::uint64_t *changed,
+		std::size_t first, std::size_t count) noexcept -> bool
+	{
+		bool anyChanged = false;
+		for (auto index = first; index < count; ++index)
+		{
+			std::uint16_t value;
+			std::memcpy(&value, raw + index * 2, sizeof(value));
+			if constexpr (kSwap)
+			{
+				value = std::uint16_t((value << 8) | (value >> 8));
+			}
+			next[index] = value;
+
+			if (value != current[index])
+			{
+				changed[index / 64] |= std::uint64_t(1) << (index % 64);
+				anyChanged = true;
+			}
+		}
+
+		return anyChanged;
+	}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+	/// @brief Converts registers eight at a time using SSE2, and collects the ones that changed
+	/// @return Whether any register changed
+	template <bool kSwap>
+	auto convertSse2(const std::byte *raw, const std::uint16_t *current, std::uint16_t *next, std::uint64_t *changed,
+		std::size_t first, std::size_t count) noexcept -> bool
+	{
+		bool anyChanged = false;
+		auto index = first;
+		for (; index + 8 <= count; index += 8)
+		{
+			auto registers = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + index * 2));
+			if constexpr (kSwap)
+			{
+				registers = _mm_or_si128(_mm_slli_epi16(registers, 8), _mm_srli_epi16(registers, 8));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(next + index), registers);
+
+			// Compare with the last image, and narrow the result to one bit per register
+			const auto equal = _mm_cmpeq_epi16(registers, _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + index)));
+			const auto changedBits = ~unsigned(_mm_movemask_epi8(_mm_packs_epi16(equal, _mm_setzero_si128()))) & 0xffu;
+			if (changedBits != 0)
+			{
+				// The index is a multiple of 8, so the bits never straddle two words
+				changed[index / 64] |= std::uint64_t(changedBits) << (index % 64);
+				anyChanged = true;
+			}
+		}
+
+		// Handle the remaining registers
+		const auto remainingChanged = convertScalar<kSwap>(raw, current, next, changed, index, count);
+		return anyChanged || remainingChanged;
+	}
+
+	/// @brief Converts registers sixteen at a time using AVX2, and collects the ones that changed
+	/// @return Whether any register changed
+	template <bool kSwap>
+	[[gnu::target("avx2")]] auto convertAvx2(const std::byte *raw, const std::uint16_t *current, std::uint16_t *next,
+		std::uint64_t *changed, std::size_t count) noexcept -> bool
+	{
+		bool anyChanged = false;
+		std::size_t index = 0;
+		for (; index + 16 <= count; index += 16)
+		{
+			auto registers = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(raw + index * 2));
+			if constexpr (kSwap)
+			{
+				registers = _mm256_or_si256(_mm256_slli_epi16(registers, 8), _mm256_srli_epi16(registers, 8));
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(next + index), registers);
+
+			// Compare with the last image. In the common case, nothing changed at all.
+			const auto equal = _mm256_cmpeq_epi16(registers, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(current + index)));
+			const auto equalBytes = unsigned(_mm256_movemask_epi8(equal));
+			if (equalBytes == 0xffffffffu)
+			{
+				continue;
+			}
+
+			// Narrow the result to one bit per register. Packing works within each 128-bit lane, so the bits of the
+			// registers of the upper lane end up in bits 16 to 23.
+			const auto packed = unsigned(_mm256_movemask_epi8(_mm256_packs_epi16(equal, _mm256_setzero_si256())));
+			const auto changedBits = ~((packed & 0xffu) | ((packed >> 8) & 0xff00u)) & 0xffffu;
+
+			// The index is a multiple of 16, so the bits never straddle two words
+			changed[index / 64] |= std::uint64_t(changedBits) << (index % 64);
+			anyChanged = true;
+		}
+
+		// Handle the remaining registers
+		const auto remainingChanged = convertSse2<kSwap>(raw, current, next, changed, index, count);
+		return anyChanged || remainingChanged;
+	}
+
+	/// @brief Checks whether the processor supports AVX2
+	auto hasAvx2() noexcept -> bool
+	{
+		static const bool hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+		return hasAvx2;
+	}
+
+#endif
+
+	/// @brief Converts all registers using the best variant the processor supports
+	/// @return Whether any register changed
+	template <bool kSwap>
+	auto convertRegisters(const std::byte *raw, const std::uint16_t *current, std::uint16_t *next, std::uint64_t *changed,
+		std::size_t count) noexcept -> bool
+	{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+		if (hasAvx2())
+		{
+			return convertAvx2<kSwap>(raw, current, next, changed, count);
+		}
+		return convertSse2<kSwap>(raw, current, next, changed, 0, count);
+#else
+		return convertScalar<kSwap>(raw, current, next, changed, 0, count);
+#endif
+	}
+
+} // namespace
+
+auto RegisterImage::parseByteOrder(std::string_view name) noexcept -> std::optional<ByteOrder>
+{
+	if (name == "big"sv)
+	{
+		return ByteOrder::BigEndian;
+	}
+	else if (name == "little"sv)
+	{
+		return ByteOrder::LittleEndian;
+	}
+
+	return std::nullopt;
+}
+
+auto RegisterImage::setLayout(std::size_t registerCount, ByteOrder byteOrder) -> void
+{
+	_registerCount = registerCount;
+	_byteOrder = byteOrder;
+
+	// Allocate all the buffers up front, so that decoding does not allocate anything
+	_raw.assign(registerCount * 2, std::byte {});
+	_current.assign(registerCount, 0);
+	_next.assign(registerCount, 0);
+	_changed.assign((registerCount + 63) / 64, 0);
+	_valid = false;
+}
+
+auto RegisterImage::addField(std::size_t pointIndex, std::size_t registerIndex, unsigned firstBit, unsigned bitCount) -> void
+{
+	// Check that the field is inside the image
+	if (registerIndex >= _registerCount)
+	{
+		throw std::runtime_error("register of template input is outside of the register image of the template I/O component");
+	}
+	if (bitCount == 0 || firstBit + bitCount > 16)
+	{
+		throw std::runtime_error("bit field of template input does not fit into a register");
+	}
+
+	_fields.push_back({ std::uint32_t(pointIndex), std::uint16_t(registerIndex), std::uint16_t((1u << bitCount) - 1),
+		std::uint8_t(firstBit) });
+}
+
+auto RegisterImage::prepare() -> void
+{
+	// Sort the fields by register, so that the fields of each register can be found directly
+	std::ranges::stable_sort(_fields, {}, &Field::_registerIndex);
+
+	_firstFields.assign(_registerCount + 1, 0);
+	std::size_t index = 0;
+	for (std::size_t registerIndex = 0; registerIndex < _registerCount; ++registerIndex)
+	{
+		_firstFields[registerIndex] = std::uint32_t(index);
+		while (index < _fields.size() && _fields[index]._registerIndex == registerIndex)
+		{
+			++index;
+		}
+	}
+	_firstFields[_registerCount] = std::uint32_t(index);
+}
+
+auto RegisterImage::convert() noexcept -> bool
+{
+	std::ranges::fill(_changed, 0);
+
+	// The registers must be swapped if the device uses a different byte order than we do
+	const auto swap = (_byteOrder == ByteOrder::BigEndian) != (std::endian::native == std::endian::big);
+	const auto anyChanged = swap ?
+		convertRegisters<true>(_raw.data(), _current.data(), _next.data(), _changed.data(), _registerCount) :
+		convertRegisters<false>(_raw.data(), _current.data(), _next.data(), _changed.data(), _registerCount);
+
+	// Without a last image, all registers count as changed
+	if (!_valid)
+	{
+		std::ranges::fill(_changed, ~std::uint64_t(0));
+		if (const auto remainder = _registerCount % 64; remainder != 0)
+		{
+			_changed.back() = (std::uint64_t(1) << remainder) - 1;
+		}
+		return _registerCount != 0;
+	}
+
+	return anyChanged;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,175 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief An image of a block of 16-bit device registers, and the bit fields that data points are mapped to
+///
+/// Devices like digital I/O modules return many values packed into 16-bit registers, which are read as a single block.
+/// The image decodes such a block into the values of the individual data points. The registers are converted from the
+/// byte order of the device and compared to the previous image in a single pass, using AVX2 or SSE2 on x86-64 processors,
+/// depending on what the processor supports, and using a scalar loop elsewhere. Only the fields of registers that changed
+/// are then looked at, and only fields whose bits changed are handed on.
+class RegisterImage final
+{
+public:
+	/// @brief The byte order of the registers on the device
+	enum class ByteOrder : std::uint8_t
+	{
+		/// @brief The most significant byte comes first
+		BigEndian,
+		/// @brief The least significant byte comes first
+		LittleEndian
+	};
+
+	/// @brief The maximum number of registers in an image
+	static constexpr std::size_t kMaxRegisters = 65536;
+
+	/// @brief Parses a byte order from a configuration value
+	/// @param name The name of the byte order, either "big" or "little"
+	/// @return The byte order, or std::nullopt if the name is not valid
+	static auto parseByteOrder(std::string_view name) noexcept -> std::optional<ByteOrder>;
+
+	/// @brief Sets the number of registers in the image, and their byte order
+	/// @param registerCount The number of registers. Must not be larger than kMaxRegisters.
+	/// @param byteOrder The byte order of the registers on the device
+	auto setLayout(std::size_t registerCount, ByteOrder byteOrder) -> void;
+
+	/// @brief Returns whether the image has any registers
+	auto enabled() const noexcept -> bool
+	{
+		return _registerCount != 0;
+	}
+
+	/// @brief Maps a data point to a bit field of a register
+	/// @param pointIndex The index of the data point
+	/// @param registerIndex The index of the register
+	/// @param firstBit The lowest bit of the field
+	/// @param bitCount The number of bits in the field. The field must fit into the register.
+	/// @throw std::runtime_error The field is outside of the image
+	auto addField(std::size_t pointIndex, std::size_t registerIndex, unsigned firstBit, unsigned bitCount) -> void;
+
+	/// @brief Prepares the image for decoding
+	///
+	/// This must be called once all the fields were added, before the first call to decode().
+	auto prepare() -> void;
+
+	/// @brief Returns the buffer the registers must be read into, in the byte order of the device
+	auto raw() noexcept -> std::span<std::byte>
+	{
+		return _raw;
+	}
+
+	/// @brief Decodes the registers that were read into the raw buffer
+	///
+	/// The function is called for all fields whose bits differ from the last decoded image. If there is no last image,
+	/// because this is the first call, or because invalidate() was called, it is called for all fields. This does not
+	/// allocate any memory.
+	/// @param function A function that will be called with the index of the data point and the value of the field
+	template <typename Function>
+	auto decode(Function &&function) -> void;
+
+	/// @brief Calls a function for the data points of all the fields
+	template <typename Function>
+	auto forEachPoint(Function &&function) const -> void
+	{
+		for (auto &&field : _fields)
+		{
+			function(std::size_t(field._pointIndex));
+		}
+	}
+
+	/// @brief Discards the last decoded image, e.g. because a read failed
+	///
+	/// The next call to decode() will hand on all fields, whether they changed or not.
+	auto invalidate() noexcept -> void
+	{
+		_valid = false;
+	}
+
+private:
+	/// @brief A bit field within a register
+	struct Field final
+	{
+		/// @brief The index of the data point
+		std::uint32_t _pointIndex;
+		/// @brief The index of the register
+		std::uint16_t _registerIndex;
+		/// @brief The mask of the field, after shifting it to the lowest bits
+		std::uint16_t _mask;
+		/// @brief The number of bits to shift the register right by
+		std::uint8_t _shift;
+	};
+
+	/// @brief Converts the raw registers into the next image, and collects the registers that changed
+	/// @return Whether any register changed
+	auto convert() noexcept -> bool;
+
+	/// @brief The number of registers
+	std::size_t _registerCount { 0 };
+	/// @brief The byte order of the registers on the device
+	ByteOrder _byteOrder { ByteOrder::BigEndian };
+
+	/// @brief The raw registers, in the byte order of the device
+	std::vector<std::byte> _raw;
+	/// @brief The last decoded image, in native byte order
+	std::vector<std::uint16_t> _current;
+	/// @brief The image being decoded, in native byte order
+	std::vector<std::uint16_t> _next;
+	/// @brief A bit for each register that is set if the register changed
+	std::vector<std::uint64_t> _changed;
+
+	/// @brief The fields, sorted by register
+	std::vector<Field> _fields;
+	/// @brief The index of the first field of each register in _fields, plus the number of fields at the end
+	std::vector<std::uint32_t> _firstFields;
+
+	/// @brief Whether _current contains a valid image
+	bool _valid { false };
+};
+
+template <typename Function>
+auto RegisterImage::decode(Function &&function) -> void
+{
+	// Convert the registers. There is nothing to do if none of them changed.
+	if (!convert())
+	{
+		return;
+	}
+
+	// Go through the registers that changed
+	for (std::size_t word = 0; word < _changed.size(); ++word)
+	{
+		for (auto bits = _changed[word]; bits != 0; bits &= bits - 1)
+		{
+			const auto registerIndex = word * 64 + std::size_t(std::countr_zero(bits));
+			const auto value = _next[registerIndex];
+
+			// Hand on the fields whose bits changed. Without a last image, all the bits count as changed.
+			const auto difference = _valid ? std::uint16_t(value ^ _current[registerIndex]) : std::uint16_t(0xffff);
+			for (auto index = _firstFields[registerIndex]; index < _firstFields[registerIndex + 1]; ++index)
+			{
+				const auto &field = _fields[index];
+				if (((difference >> field._shift) & field._mask) != 0)
+				{
+					function(std::size_t(field._pointIndex), unsigned((value >> field._shift) & field._mask));
+				}
+			}
+		}
+	}
+
+	// The new image becomes the last one
+	_current.swap(_next);
+	_valid = true;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,86 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A streaming accumulator for the statistics of a series of samples.
+///
+/// The accumulator has a fixed size and never allocates memory, so it can be used on the read path.
+class SampleStatistics final
+{
+public:
+	/// @brief Clears all accumulated samples
+	auto reset() noexcept -> void
+	{
+		*this = {};
+	}
+
+	/// @brief Adds a sample
+	auto add(double sample) noexcept -> void
+	{
+		_minimum = std::min(_minimum, sample);
+		_maximum = std::max(_maximum, sample);
+		_sum += sample;
+		_sumOfSquares += sample * sample;
+		_last = sample;
+		++_count;
+	}
+
+	/// @brief Returns the number of samples
+	auto count() const noexcept -> std::size_t
+	{
+		return _count;
+	}
+
+	/// @brief Returns the smallest sample, or NaN if there are no samples
+	auto minimum() const noexcept -> double
+	{
+		return _count ? _minimum : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	/// @brief Returns the largest sample, or NaN if there are no samples
+	auto maximum() const noexcept -> double
+	{
+		return _count ? _maximum : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	/// @brief Returns the arithmetic mean of the samples, or NaN if there are no samples
+	auto mean() const noexcept -> double
+	{
+		return _count ? _sum / double(_count) : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	/// @brief Returns the root mean square of the samples, or NaN if there are no samples
+	auto rms() const noexcept -> double
+	{
+		return _count ? std::sqrt(_sumOfSquares / double(_count)) : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	/// @brief Returns the last sample, or NaN if there are no samples
+	auto last() const noexcept -> double
+	{
+		return _count ? _last : std::numeric_limits<double>::quiet_NaN();
+	}
+
+private:
+	/// @brief The smallest sample so far
+	double _minimum { std::numeric_limits<double>::infinity() };
+	/// @brief The largest sample so far
+	double _maximum { -std::numeric_limits<double>::infinity() };
+	/// @brief The sum of all samples
+	double _sum { 0 };
+	/// @brief The sum of the squares of all samples
+	double _sumOfSquares { 0 };
+	/// @brief The last sample
+	double _last { 0 };
+	/// @brief The number of samples
+	std::size_t _count { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,211 @@
+// Copyright (c) embedded ocean GmbH
+#include "ScalingTable.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#	include <immintrin.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	// The vectorized variants load each scaling as a whole, including the padding
+	static_assert(sizeof(ScalingTable::Scaling) == 8 * sizeof(double));
+
+	/// @brief Scales a block one value at a time
+	template <typename Raw>
+	auto scaleScalar(const ScalingTable::Scaling *scalings, const std::uint32_t *pointIndices, const Raw *raw, double *values, std::size_t count) noexcept
+		-> void
+	{
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			values[index] = ScalingTable::scale(scalings[pointIndices[index]], double(raw[index]));
+		}
+	}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+	/// @brief Loads two raw values and converts them to double, using SSE2
+	template <typename Raw>
+	auto loadSse2(const Raw *raw) noexcept -> __m128d
+	{
+		if constexpr (std::is_same_v<Raw, double>)
+		{
+			return _mm_loadu_pd(raw);
+		}
+		else if constexpr (std::is_same_v<Raw, float>)
+		{
+			return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(raw))));
+		}
+		else if constexpr (std::is_same_v<Raw, std::int32_t>)
+		{
+			return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(raw)));
+		}
+		else
+		{
+			// SSE2 has no sign extension, so we move each value into the upper half of a 32-bit lane, and shift it back down
+			int packed;
+			std::memcpy(&packed, raw, sizeof(packed));
+			const auto words = _mm_cvtsi32_si128(packed);
+			return _mm_cvtepi32_pd(_mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16));
+		}
+	}
+
+	/// @brief Scales a block two values at a time, using SSE2
+	template <typename Raw>
+	auto scaleSse2(const ScalingTable::Scaling *scalings, const std::uint32_t *pointIndices, const Raw *raw, double *values, std::size_t count) noexcept
+		-> void
+	{
+		std::size_t index = 0;
+		for (; index + 2 <= count; index += 2)
+		{
+			// Load the scalings of both data points, and transpose them, so that each register holds the same coefficient
+			// of both data points
+			const auto *first = reinterpret_cast<const double *>(scalings + pointIndices[index]);
+			const auto *second = reinterpret_cast<const double *>(scalings + pointIndices[index + 1]);
+			const auto transpose = [&](std::size_t member, auto unpack) {
+				return unpack(_mm_load_pd(first + member), _mm_load_pd(second + member));
+			};
+			const auto low = [](__m128d a, __m128d b) { return _mm_unpacklo_pd(a, b); };
+			const auto high = [](__m128d a, __m128d b) { return _mm_unpackhi_pd(a, b); };
+
+			const auto x = loadSse2(raw + index);
+			auto value = _mm_add_pd(_mm_mul_pd(transpose(2, high), x), transpose(2, low));
+			value = _mm_add_pd(_mm_mul_pd(value, x), transpose(0, high));
+			value = _mm_add_pd(_mm_mul_pd(value, x), transpose(0, low));
+
+			// Keep non-finite raw values. Integers are always finite.
+			if constexpr (std::is_floating_point_v<Raw>)
+			{
+				const auto finite = _mm_cmpeq_pd(_mm_sub_pd(x, x), _mm_setzero_pd());
+				value = _mm_or_pd(_mm_and_pd(finite, value), _mm_andnot_pd(finite, x));
+			}
+
+			// Clamp the value. The operand order makes NaN pass through, like in the scalar code.
+			value = _mm_max_pd(transpose(4, low), _mm_min_pd(transpose(4, high), value));
+			_mm_storeu_pd(values + index, value);
+		}
+
+		// Handle the odd value at the end
+		scaleScalar(scalings, pointIndices + index, raw + index, values + index, count - index);
+	}
+
+	/// @brief Loads four raw values and converts them to double, using AVX2
+	template <typename Raw>
+	[[gnu::target("avx2")]] auto loadAvx2(const Raw *raw) noexcept -> __m256d
+	{
+		if constexpr (std::is_same_v<Raw, double>)
+		{
+			return _mm256_loadu_pd(raw);
+		}
+		else if constexpr (std::is_same_v<Raw, float>)
+		{
+			return _mm256_cvtps_pd(_mm_loadu_ps(raw));
+		}
+		else if constexpr (std::is_same_v<Raw, std::int32_t>)
+		{
+			return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(raw)));
+		}
+		else
+		{
+			return _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(raw))));
+		}
+	}
+
+	/// @brief Scales a block four values at a time, using AVX2
+	template <typename Raw>
+	[[gnu::target("avx2")]] auto scaleAvx2(
+		const ScalingTable::Scaling *scalings, const std::uint32_t *pointIndices, const Raw *raw, double *values, std::size_t count) noexcept -> void
+	{
+		std::size_t index = 0;
+		for (; index + 4 <= count; index += 4)
+		{
+			// Load the scalings of the four data points. Each one is a single aligned cache line, so loading them whole and
+			// transposing them in registers is cheaper than gathering each coefficient separately.
+			const auto *first = reinterpret_cast<const double *>(scalings + pointIndices[index]);
+			const auto *second = reinterpret_cast<const double *>(scalings + pointIndices[index + 1]);
+			const auto *third = reinterpret_cast<const double *>(scalings + pointIndices[index + 2]);
+			const auto *fourth = reinterpret_cast<const double *>(scalings + pointIndices[index + 3]);
+
+			// Transpose the coefficients, so that each register holds the same coefficient of all four data points
+			const auto low01 = _mm256_unpacklo_pd(_mm256_load_pd(first), _mm256_load_pd(second));
+			const auto high01 = _mm256_unpackhi_pd(_mm256_load_pd(first), _mm256_load_pd(second));
+			const auto low23 = _mm256_unpacklo_pd(_mm256_load_pd(third), _mm256_load_pd(fourth));
+			const auto high23 = _mm256_unpackhi_pd(_mm256_load_pd(third), _mm256_load_pd(fourth));
+			const auto coefficient0 = _mm256_permute2f128_pd(low01, low23, 0x20);
+			const auto coefficient1 = _mm256_permute2f128_pd(high01, high23, 0x20);
+			const auto coefficient2 = _mm256_permute2f128_pd(low01, low23, 0x31);
+			const auto coefficient3 = _mm256_permute2f128_pd(high01, high23, 0x31);
+
+			// Transpose the limits the same way
+			const auto limits01 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_load_pd(first + 4)), _mm_load_pd(third + 4), 1);
+			const auto limits23 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_load_pd(second + 4)), _mm_load_pd(fourth + 4), 1);
+			const auto minimum = _mm256_unpacklo_pd(limits01, limits23);
+			const auto maximum = _mm256_unpackhi_pd(limits01, limits23);
+
+			const auto x = loadAvx2(raw + index);
+			auto value = _mm256_add_pd(_mm256_mul_pd(coefficient3, x), coefficient2);
+			value = _mm256_add_pd(_mm256_mul_pd(value, x), coefficient1);
+			value = _mm256_add_pd(_mm256_mul_pd(value, x), coefficient0);
+
+			// Keep non-finite raw values. Integers are always finite.
+			if constexpr (std::is_floating_point_v<Raw>)
+			{
+				const auto finite = _mm256_cmp_pd(_mm256_sub_pd(x, x), _mm256_setzero_pd(), _CMP_EQ_OQ);
+				value = _mm256_blendv_pd(x, value, finite);
+			}
+
+			// Clamp the value. The operand order makes NaN pass through, like in the scalar code.
+			value = _mm256_max_pd(minimum, _mm256_min_pd(maximum, value));
+			_mm256_storeu_pd(values + index, value);
+		}
+
+		// Handle the remaining values
+		scaleSse2(scalings, pointIndices + index, raw + index, values + index, count - index);
+	}
+
+	/// @brief Checks whether the processor supports AVX2
+	auto hasAvx2() noexcept -> bool
+	{
+		static const bool hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+		return hasAvx2;
+	}
+
+#endif
+
+} // namespace
+
+template <typename Raw>
+auto ScalingTable::scale(std::span<const std::uint32_t> pointIndices, std::span<const Raw> raw, std::span<double> values) const noexcept -> void
+{
+	const auto count = pointIndices.size();
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	// Use the widest instructions the processor supports
+	if (hasAvx2())
+	{
+		scaleAvx2(_scalings.data(), pointIndices.data(), raw.data(), values.data(), count);
+	}
+	else
+	{
+		scaleSse2(_scalings.data(), pointIndices.data(), raw.data(), values.data(), count);
+	}
+#else
+	scaleScalar(_scalings.data(), pointIndices.data(), raw.data(), values.data(), count);
+#endif
+}
+
+/// @cond
+template auto ScalingTable::scale<std::int16_t>(std::span<const std::uint32_t>, std::span<const std::int16_t>, std::span<double>) const noexcept -> void;
+template auto ScalingTable::scale<std::int32_t>(std::span<const std::uint32_t>, std::span<const std::int32_t>, std::span<double>) const noexcept -> void;
+template auto ScalingTable::scale<float>(std::span<const std::uint32_t>, std::span<const float>, std::span<double>) const noexcept -> void;
+template auto ScalingTable::scale<double>(std::span<const std::uint32_t>, std::span<const double>, std::span<double>) const noexcept -> void;
+/// @endcond
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
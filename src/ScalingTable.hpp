@@ -0,0 +1,101 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Converts raw device values into engineering units for all the data points of an I/O component.
+///
+/// Each data point has a polynomial of up to third degree, and an optional range the result is clamped to. Data points
+/// without scaling use the identity. Non-finite raw values are not scaled, but still clamped.
+///
+/// The scalings are stored contiguously, with the complete scaling of each data point in a single cache line, so that
+/// scaling a block of values for arbitrary data points touches only one line per data point. Blocks are scaled using
+/// AVX2 or SSE2 on x86-64 processors, depending on what the processor supports, and using a scalar loop elsewhere. All
+/// variants evaluate the polynomial in the same order, using separate multiplications and additions.
+class ScalingTable final
+{
+public:
+	/// @brief The scaling of a single data point
+	struct alignas(64) Scaling final
+	{
+		/// @brief The coefficients of the polynomial, lowest order first
+		std::array<double, 4> _coefficients { 0.0, 1.0, 0.0, 0.0 };
+		/// @brief The lowest value after scaling
+		double _minimum { -std::numeric_limits<double>::infinity() };
+		/// @brief The highest value after scaling
+		double _maximum { std::numeric_limits<double>::infinity() };
+	};
+
+	/// @brief Makes room for the given number of data points. New data points use the identity.
+	auto resize(std::size_t pointCount) -> void
+	{
+		_scalings.resize(pointCount);
+	}
+
+	/// @brief Sets the scaling of a data point
+	/// @param pointIndex The index of the data point, which must have been made room for using resize()
+	/// @param scaling The scaling
+	auto set(std::size_t pointIndex, const Scaling &scaling) noexcept -> void
+	{
+		_scalings[pointIndex] = scaling;
+		_enabled = true;
+	}
+
+	/// @brief Checks whether any data point has a scaling
+	auto enabled() const noexcept -> bool
+	{
+		return _enabled;
+	}
+
+	/// @brief Scales a single raw value
+	/// @param pointIndex The index of the data point
+	/// @param raw The raw value
+	/// @return The value in engineering units
+	auto scale(std::size_t pointIndex, double raw) const noexcept -> double
+	{
+		return scale(_scalings[pointIndex], raw);
+	}
+
+	/// @brief Scales a block of raw values in one pass
+	///
+	/// This is supported for raw values of type std::int16_t, std::int32_t, float and double.
+	/// @param pointIndices The index of the data point of each value
+	/// @param raw The raw values. Must have the same size as @a pointIndices.
+	/// @param values Receives the values in engineering units. Must have the same size as @a pointIndices.
+	template <typename Raw>
+	auto scale(std::span<const std::uint32_t> pointIndices, std::span<const Raw> raw, std::span<double> values) const noexcept -> void;
+
+	/// @brief Scales a single raw value using a scaling
+	///
+	/// The vectorized variants compute exactly the same thing in exactly the same order.
+	static auto scale(const Scaling &scaling, double raw) noexcept -> double
+	{
+		// Only scale finite values. x - x is only zero if x is finite.
+		auto value = raw;
+		if (raw - raw == 0.0)
+		{
+			const auto &coefficients = scaling._coefficients;
+			value = ((coefficients[3] * raw + coefficients[2]) * raw + coefficients[1]) * raw + coefficients[0];
+		}
+
+		// Clamp the value. NaN stays NaN.
+		value = value > scaling._maximum ? scaling._maximum : value;
+		return value < scaling._minimum ? scaling._minimum : value;
+	}
+
+private:
+	/// @brief The scalings of all the data points, indexed by point index
+	std::vector<Scaling> _scalings;
+	/// @brief Whether any data point has a scaling
+	bool _enabled { false };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
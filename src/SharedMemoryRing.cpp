@@ -0,0 +1,116 @@
+// Copyright (c) embedded ocean GmbH
+#include "SharedMemoryRing.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#if defined(__unix__)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+#if defined(__unix__)
+
+SharedMemoryRing::SharedMemoryRing(std::string name, std::size_t capacity) :
+	_name(std::move(name)),
+	_mappedSize(sizeof(Header) + capacity * sizeof(IoRecord)),
+	_mask(capacity - 1)
+{
+	// Open or create the shared memory object
+	const auto fileDescriptor = ::shm_open(_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fileDescriptor < 0)
+	{
+		throw std::system_error(errno, std::generic_category(), "could not open shared memory ring " + _name);
+	}
+
+	// Give a new object its size. An existing object must have the right size already.
+	struct ::stat status {};
+	::fstat(fileDescriptor, &status);
+	const auto created = status.st_size == 0;
+	if (created && ::ftruncate(fileDescriptor, ::off_t(_mappedSize)) < 0)
+	{
+		const auto error = errno;
+		::close(fileDescriptor);
+		throw std::system_error(error, std::generic_category(), "could not size shared memory ring " + _name);
+	}
+	if (!created && std::size_t(status.st_size) != _mappedSize)
+	{
+		::close(fileDescriptor);
+		throw std::system_error(std::make_error_code(std::errc::invalid_argument), "shared memory ring " + _name + " has the wrong size");
+	}
+
+	// Map the object. The mapping keeps the object alive, so we don't need the file descriptor any more.
+	auto memory = ::mmap(nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+	const auto mapError = errno;
+	::close(fileDescriptor);
+	if (memory == MAP_FAILED)
+	{
+		throw std::system_error(mapError, std::generic_category(), "could not map shared memory ring " + _name);
+	}
+	_header = static_cast<Header *>(memory);
+	_records = reinterpret_cast<IoRecord *>(static_cast<std::byte *>(memory) + sizeof(Header));
+
+	// Initialize a new ring. The memory is zero filled, so the indices already start at 0.
+	if (created)
+	{
+		_header->_version = kVersion;
+		_header->_capacity = capacity;
+		_header->_magic.store(kMagic, std::memory_order_release);
+	}
+	// Check an existing ring
+	else if (_header->_magic.load(std::memory_order_acquire) != kMagic ||
+		_header->_version != kVersion || _header->_capacity != capacity)
+	{
+		::munmap(memory, _mappedSize);
+		throw std::system_error(std::make_error_code(std::errc::invalid_argument), "shared memory ring " + _name + " is incompatible");
+	}
+
+	// Pick up where the other side left off
+	_cachedHead = _header->_head.load(std::memory_order_acquire);
+	_cachedTail = _header->_tail.load(std::memory_order_acquire);
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+	::munmap(_header, _mappedSize);
+	::shm_unlink(_name.c_str());
+}
+
+#else
+
+SharedMemoryRing::SharedMemoryRing(std::string name, std::size_t capacity)
+{
+	throw std::system_error(std::make_error_code(std::errc::operation_not_supported), "shared memory rings are not supported on this system");
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+}
+
+#endif
+
+auto SharedMemoryRing::tryPush(const IoRecord &record) noexcept -> bool
+{
+	const auto head = _header->_head.load(std::memory_order_relaxed);
+
+	// Only look at the shared tail if the ring seems to be full
+	if (head - _cachedTail > _mask)
+	{
+		_cachedTail = _header->_tail.load(std::memory_order_acquire);
+		if (head - _cachedTail > _mask)
+		{
+			return false;
+		}
+	}
+
+	_records[head & _mask] = record;
+	_header->_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,138 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "IoRecord.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A single-producer, single-consumer ring of @ref IoRecord structures in POSIX shared memory.
+///
+/// This is used to exchange values with producer processes running on the same machine, like simulators or inference
+/// services. The shared memory object consists of a @ref Header, followed by the records. The head and tail indices
+/// are on cache lines of their own, so the producer and consumer do not contend for the same cache line. Each side
+/// also keeps a private copy of the other side's index, and only reads the shared index when the private copy says
+/// that the ring is full or empty.
+///
+/// When used as transport, the _offset member of each record contains the time stamp of the value in nanoseconds since
+/// the epoch of std::chrono::system_clock, or 0 if the consumer should use its own time stamp. The _duration member is
+/// not used.
+///
+/// @note The object is not thread safe. Only one thread may push, and only one thread may consume, at a time.
+class SharedMemoryRing final
+{
+public:
+	/// @brief The layout of the start of the shared memory object
+	struct Header final
+	{
+		/// @brief Identifies an initialized ring. This is set last, once all other members are valid.
+		std::atomic<std::uint32_t> _magic;
+		/// @brief The version of the layout
+		std::uint32_t _version;
+		/// @brief The number of records, which is a power of two
+		std::uint64_t _capacity;
+		/// @brief The sequence number of the next record to be pushed. Only written by the producer.
+		alignas(64) std::atomic<std::uint64_t> _head;
+		/// @brief The sequence number of the next record to be consumed. Only written by the consumer.
+		alignas(64) std::atomic<std::uint64_t> _tail;
+	};
+
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared memory rings need address-free atomics");
+	static_assert(sizeof(Header) % alignof(IoRecord) == 0);
+
+	/// @brief The value of Header::_magic for an initialized ring
+	static constexpr std::uint32_t kMagic { 0x58535252 };
+	/// @brief The current value of Header::_version
+	static constexpr std::uint32_t kVersion { 1 };
+
+	/// @brief Whether shared memory rings are supported on this system
+#if defined(__unix__)
+	static constexpr bool kSupported { true };
+#else
+	static constexpr bool kSupported { false };
+#endif
+
+	/// @brief Opens a ring, creating it if it does not exist yet
+	/// @param name The POSIX name of the shared memory object, which must start with a slash
+	/// @param capacity The number of records, which must be a power of two. If the ring already exists, it must have the
+	/// same capacity.
+	/// @throw std::system_error if the ring could not be opened
+	SharedMemoryRing(std::string name, std::size_t capacity);
+
+	/// @brief Unmaps and removes the ring. Processes that still have it open can continue to use it.
+	~SharedMemoryRing();
+
+	SharedMemoryRing(const SharedMemoryRing &) = delete;
+	auto operator=(const SharedMemoryRing &) -> SharedMemoryRing & = delete;
+
+	/// @brief Pushes a record, if there is room
+	/// @return Whether the record was pushed
+	auto tryPush(const IoRecord &record) noexcept -> bool;
+
+	/// @brief Calls a function for each available record, in place.
+	///
+	/// The records are passed by reference to the shared memory, so nothing is copied. The consumed records are released
+	/// to the producer in one go, once the function has been called for all of them.
+	/// @param function The function to call
+	/// @return The number of records consumed
+	template <typename Function>
+	auto consume(Function &&function) -> std::size_t;
+
+private:
+	/// @brief The name of the shared memory object
+	std::string _name;
+	/// @brief The size of the mapping
+	std::size_t _mappedSize { 0 };
+	/// @brief The header
+	Header *_header { nullptr };
+	/// @brief The records
+	IoRecord *_records { nullptr };
+	/// @brief The mask used to turn sequence numbers into indices
+	std::uint64_t _mask { 0 };
+
+	/// @brief The last known head, as seen by the consumer
+	std::uint64_t _cachedHead { 0 };
+	/// @brief The last known tail, as seen by the producer
+	std::uint64_t _cachedTail { 0 };
+};
+
+template <typename Function>
+auto SharedMemoryRing::consume(Function &&function) -> std::size_t
+{
+	auto tail = _header->_tail.load(std::memory_order_relaxed);
+
+	// Only look at the shared head once all the records we know of have been consumed
+	if (tail == _cachedHead)
+	{
+		_cachedHead = _header->_head.load(std::memory_order_acquire);
+		if (tail == _cachedHead)
+		{
+			return 0;
+		}
+	}
+
+	// If the producer claims more records than fit into the ring, skip the ones that have been overwritten
+	const auto head = _cachedHead;
+	if (head - tail > _mask + 1)
+	{
+		tail = head - (_mask + 1);
+	}
+
+	// Hand out all records in place, and release them in one go
+	const auto count = std::size_t(head - tail);
+	for (; tail != head; ++tail)
+	{
+		function(std::as_const(_records[tail & _mask]));
+	}
+	_header->_tail.store(tail, std::memory_order_release);
+
+	return count;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,118 @@
+// Copyright (c) embedded ocean GmbH
+#include "SharedMemoryTransport.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <array>
+#include <thread>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief The number of values that are scaled together
+	constexpr std::size_t kBlockSize = 64;
+
+} // namespace
+
+SharedMemoryTransport::SharedMemoryTransport(const std::string &name, std::size_t capacity,
+	std::span<const std::reference_wrapper<ReadState<double>>> points, const ScalingTable &scaling) :
+	_inputRing(name + ".in", capacity),
+	_outputRing(name + ".out", capacity),
+	_points(points),
+	_scaling(scaling)
+{
+}
+
+auto SharedMemoryTransport::receive(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Let any other thread that is already receiving do the work
+	if (_receiving.test_and_set(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	// The values are collected into a block on the stack, so they can be scaled together
+	const auto &scaling = _scaling.get();
+	std::array<std::uint32_t, kBlockSize> pointIndices;
+	std::array<double, kBlockSize> rawValues;
+	std::array<double, kBlockSize> values;
+	std::array<std::chrono::system_clock::time_point, kBlockSize> recordTimes;
+	std::size_t blockSize = 0;
+
+	// Scales the values in the block, and dispatches them to their data points
+	const auto flush = [&]() {
+		const auto &scaledValues = scaling.enabled() ? values : rawValues;
+		if (scaling.enabled())
+		{
+			scaling.scale<double>(std::span(pointIndices).first(blockSize), std::span(rawValues).first(blockSize), std::span(values).first(blockSize));
+		}
+		for (std::size_t index = 0; index < blockSize; ++index)
+		{
+			_points[pointIndices[index]].get().update(recordTimes[index], scaledValues[index]);
+		}
+		blockSize = 0;
+	};
+
+	_inputRing.consume([&](const IoRecord &record) {
+		// Ignore records that don't belong to any of our data points
+		if (record._kind != IoRecord::Kind::Read || record._pointIndex >= _points.size())
+		{
+			return;
+		}
+
+		// Use the time stamp of the producer, if it sent one
+		const auto recordTime = record._offset != 0 ?
+			std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(record._offset))) :
+			timeStamp;
+
+		// Errors are dispatched right away, after any values before them, so that the updates stay in order
+		if (const auto error = record.error())
+		{
+			flush();
+			_points[record._pointIndex].get().update(recordTime, utils::eh::unexpected(error));
+			return;
+		}
+
+		// Add the value to the block
+		pointIndices[blockSize] = record._pointIndex;
+		rawValues[blockSize] = record._value;
+		recordTimes[blockSize] = recordTime;
+		if (++blockSize == kBlockSize)
+		{
+			flush();
+		}
+	});
+
+	// Dispatch the rest of the values
+	flush();
+
+	_receiving.clear(std::memory_order_release);
+}
+
+auto SharedMemoryTransport::send(std::size_t pointIndex, double value) noexcept -> std::error_code
+{
+	IoRecord record;
+	record._offset = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	record._pointIndex = std::uint32_t(pointIndex);
+	record._kind = IoRecord::Kind::Write;
+	record._value = value;
+
+	// Pushing only takes a few stores, so we just yield to any other thread that is sending
+	while (_sending.test_and_set(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+	const auto pushed = _outputRing.tryPush(record);
+	_sending.clear(std::memory_order_release);
+
+	if (!pushed)
+	{
+		return std::make_error_code(std::errc::no_buffer_space);
+	}
+	return {};
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
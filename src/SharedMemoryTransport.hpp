@@ -0,0 +1,72 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ReadState.hpp"
+#include "ScalingTable.hpp"
+#include "SharedMemoryRing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <system_error>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Exchanges values with a producer process on the same machine using two shared memory rings.
+///
+/// The producer pushes the values of the inputs into the ring called <em>name</em>.in, using @ref IoRecord structures
+/// of kind IoRecord::Kind::Read. The driver pushes the values written to outputs into the ring called
+/// <em>name</em>.out, using records of kind IoRecord::Kind::Write.
+///
+/// The records are consumed in place, and dispatched directly to the read states of the data points they belong to.
+/// If any data points have a scaling, the values are collected into blocks first, so that each block can be converted into
+/// engineering units in a single vectorized pass before it is dispatched.
+class SharedMemoryTransport final
+{
+public:
+	/// @brief Opens the rings
+	/// @param name The POSIX name the ring names are derived from
+	/// @param capacity The number of records in each ring
+	/// @param points The read states of all the data points of the I/O component, indexed by point index
+	/// @param scaling The scaling of the values of all the data points
+	/// @throw std::system_error if the rings could not be opened
+	/// @todo use the correct value type
+	SharedMemoryTransport(const std::string &name, std::size_t capacity, std::span<const std::reference_wrapper<ReadState<double>>> points,
+		const ScalingTable &scaling);
+
+	/// @brief Updates the data points with all records the producer has sent.
+	///
+	/// This can be called from the "read" tasks of any number of data points. If another thread is already receiving,
+	/// the function returns right away, and the other thread handles the records.
+	/// @param timeStamp The time stamp to use for records that don't carry their own
+	auto receive(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Sends a value written to an output to the producer
+	/// @param pointIndex The index of the output within the I/O component
+	/// @param value The value
+	/// @return An error if the ring was full, or a default constructed std::error_code on success
+	auto send(std::size_t pointIndex, double value) noexcept -> std::error_code;
+
+private:
+	/// @brief The ring the producer sends the input values in
+	SharedMemoryRing _inputRing;
+	/// @brief The ring the output values are sent to the producer in
+	SharedMemoryRing _outputRing;
+
+	/// @brief The read states of all the data points
+	/// @todo use the correct value type
+	std::span<const std::reference_wrapper<ReadState<double>>> _points;
+	/// @brief The scaling of the values of all the data points
+	std::reference_wrapper<const ScalingTable> _scaling;
+
+	/// @brief Set while a thread is receiving, because the input ring only supports one consumer
+	std::atomic_flag _receiving;
+	/// @brief Set while a thread is sending, because the output ring only supports one producer
+	std::atomic_flag _sending;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,27 @@
+// Copyright (c) embedded ocean GmbH
+#include "SingleValueQueue.hpp"
+
+#include <cstdint>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief A value with a time stamp, which is 16 bytes long and therefore does not fit into a lock-free atomic
+	struct TimestampedValue final
+	{
+		/// @brief The value
+		double _value { 0.0 };
+		/// @brief The time stamp, in nanoseconds since the epoch
+		std::int64_t _timeStamp { 0 };
+	};
+
+} // namespace
+
+// Instantiate the version for values that do not fit into a lock-free atomic, so that it is compiled and checked even
+// though the data points of the template only use values of type double
+template class SingleValueQueue<TimestampedValue, false>;
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -3,38 +3,206 @@
 
 #include <xentara/utils/atomic/Optional.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
 namespace xentara::plugins::templateDriver
 {
 
+/// @brief A value that was taken from a @ref SingleValueQueue
+template <typename DataType>
+struct QueuedValue final
+{
+	/// @brief The value
+	DataType _value;
+	/// @brief The time the value was enqueued
+	std::chrono::steady_clock::time_point _enqueueTime;
+};
+
+/// @brief Determines whether a @ref SingleValueQueue for a type can be implemented using a single lock-free atomic
+template <typename DataType>
+inline constexpr bool kIsLockFreeQueueable = utils::atomic::Optional<DataType>::is_always_lock_free;
+
 /// @brief A thread-safe, lock-free queue that can hold a single value.
 ///
 /// This queues only allows enqueuing a single value. Enqueuing a second value will overwrite the first.
-template <typename DataType>
+///
+/// Along with the value, the queue records the time it was enqueued, so that consumers can detect values that have
+/// become too old to be used.
+///
+/// Values that fit into a lock-free atomic use a single atomic, and are handled by the primary template. Larger values
+/// are handled by a specialization that uses a sequence lock instead.
+template <typename DataType, bool kLockFree = kIsLockFreeQueueable<DataType>>
 class SingleValueQueue final
 {
 public:
+	/// @brief A value that was taken from the queue
+	using Item = QueuedValue<DataType>;
+
 	/// @brief Enqueues a value.
 	/// 
 	/// Any value already in the queue will be replaced.
 	/// @param value The value to place in the queue
 	auto enqueue(const DataType &value) noexcept -> void
 	{
+		// The time is stored separately before the value, because the value and the time together are not lock free.
+		// dequeue() reads the time after taking the value, so it always sees the time of the value it took, or of a
+		// value enqueued concurrently. A fresh value is therefore never treated as stale. A value can at most seem as
+		// new as a value that is being enqueued at the same time, and which will be dequeued right after it.
+		_enqueueTime.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_release);
+
 		_value.store(value, std::memory_order_release);
 	}
 
 	/// @brief Gets the last scheduled value and removes it from the queue
-	/// @return The scheduled value or std::nullopt if none was scheduled since the last call
-	auto dequeue() noexcept -> std::optional<DataType>
+	/// @return The scheduled value and its enqueue time, or std::nullopt if none was scheduled since the last call
+	auto dequeue() noexcept -> std::optional<Item>
 	{
-		return _value.exchange(std::nullopt, std::memory_order_acq_rel);
+		auto value = _value.exchange(std::nullopt, std::memory_order_acq_rel);
+		if (!value)
+		{
+			return std::nullopt;
+		}
+
+		// Read the time after the value, so it can never be older than the value (see enqueue())
+		const std::chrono::steady_clock::duration enqueueTime { _enqueueTime.load(std::memory_order_acquire) };
+
+		return Item { *value, std::chrono::steady_clock::time_point(enqueueTime) };
 	}
 
 private:
 	/// @brief The queued value, or std::nullopt if the queue is empty.
 	utils::atomic::Optional<DataType> _value;
+	/// @brief The time the last value was enqueued, in steady clock ticks
+	std::atomic<std::chrono::steady_clock::rep> _enqueueTime { 0 };
 
 	// Check that the value is lock free, or blocking will occurr
 	static_assert(decltype(_value)::is_always_lock_free);
 };
 
+/// @brief A thread-safe queue that can hold a single value that does not fit into a lock-free atomic.
+///
+/// The value and its enqueue time are stored together under a sequence lock. Writers never wait: if a writer finds
+/// another writer in the middle of storing a value, it simply abandons its own value, since the two writes are
+/// concurrent, and the other value may just as well be considered the later one. Readers retry if a writer stores a value
+/// while they are copying it. If writers keep interfering, or a writer was preempted while storing a value, the reader
+/// gives up after a few attempts, and leaves the value in the queue for its next call, so that the task taking the values
+/// never waits for a writer.
+///
+/// This is used for timestamped values, structures and short arrays, which would otherwise need a mutex on the
+/// write handle path.
+///
+/// @note dequeue() must only be called by a single thread at a time.
+template <typename DataType>
+	requires std::is_trivially_copyable_v<DataType> && std::default_initializable<DataType>
+class SingleValueQueue<DataType, false> final
+{
+public:
+	/// @brief A value that was taken from the queue
+	using Item = QueuedValue<DataType>;
+
+	/// @brief Enqueues a value.
+	/// 
+	/// Any value already in the queue will be replaced.
+	/// @param value The value to place in the queue
+	auto enqueue(const DataType &value) noexcept -> void
+	{
+		// Acquire the slot. If another writer holds it, our value is superseded by theirs, so we just bail.
+		auto sequence = _sequence.load(std::memory_order_relaxed);
+		if ((sequence & 1) != 0 ||
+			!_sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return;
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+
+		// Store the payload
+		Words words {};
+		std::memcpy(words.data(), &value, sizeof(DataType));
+		for (std::size_t index = 0; index < kWordCount; ++index)
+		{
+			_words[index].store(words[index], std::memory_order_relaxed);
+		}
+		_enqueueTime.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+
+		// Publish the value
+		_sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/// @brief Gets the last scheduled value and removes it from the queue
+	/// @return The scheduled value and its enqueue time, or std::nullopt if none was scheduled since the last call, or if
+	/// writers kept storing values while it was being copied
+	auto dequeue() noexcept -> std::optional<Item>
+	{
+		for (std::size_t attempt = 0; attempt < kMaxAttempts; ++attempt)
+		{
+			const auto sequence = _sequence.load(std::memory_order_acquire);
+
+			// Check if a value was enqueued since we last looked
+			if (sequence == _consumedSequence)
+			{
+				return std::nullopt;
+			}
+			// Wait for any writer to finish. We yield, because the writer might have been preempted while holding the lock.
+			if ((sequence & 1) != 0)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Copy the payload
+			Words words;
+			for (std::size_t index = 0; index < kWordCount; ++index)
+			{
+				words[index] = _words[index].load(std::memory_order_relaxed);
+			}
+			const std::chrono::steady_clock::duration enqueueTime { _enqueueTime.load(std::memory_order_relaxed) };
+
+			// Check that no writer interfered
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (_sequence.load(std::memory_order_relaxed) != sequence)
+			{
+				continue;
+			}
+
+			_consumedSequence = sequence;
+
+			// The value is trivially copyable, so it can be copied as bytes even if it has a default member initializer
+			Item item { {}, std::chrono::steady_clock::time_point(enqueueTime) };
+			std::memcpy(static_cast<void *>(&item._value), words.data(), sizeof(DataType));
+			return item;
+		}
+
+		// Writers kept interfering. The value stays in the queue, and is taken by the next call.
+		return std::nullopt;
+	}
+
+private:
+	/// @brief How often dequeue() tries to copy a value before giving up
+	static constexpr std::size_t kMaxAttempts = 64;
+	/// @brief The number of 64 bit words needed to hold a value
+	static constexpr std::size_t kWordCount = (sizeof(DataType) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+	/// @brief A local copy of the payload
+	using Words = std::array<std::uint64_t, kWordCount>;
+
+	/// @brief The sequence number. This is odd while a writer is storing a value, and increases by two with every value.
+	std::atomic<std::uint64_t> _sequence { 0 };
+	/// @brief The sequence number of the last value that was dequeued. This is only accessed by the reader.
+	std::uint64_t _consumedSequence { 0 };
+
+	/// @brief The value, stored as words using atomics with relaxed ordering, so that a reader racing with a writer
+	/// reads a torn value instead of invoking undefined behaviour. Torn values are detected using the sequence number.
+	std::array<std::atomic<std::uint64_t>, kWordCount> _words {};
+	/// @brief The time the value was enqueued, in steady clock ticks
+	std::atomic<std::chrono::steady_clock::rep> _enqueueTime { 0 };
+};
+
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,203 @@
+// Copyright (c) embedded ocean GmbH
+#include "StartupReader.hpp"
+
+#include "Attributes.hpp"
+
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/process/EventList.hpp>
+
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief How often the statistics are published while initial reads are still completing
+	constexpr std::uint64_t kPublishInterval = 1024;
+
+} // namespace
+
+auto StartupReader::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support
+	return
+		function(attributes::kPendingInitialReads) ||
+		function(attributes::kFirstValueTimeMedian) ||
+		function(attributes::kFirstValueTimeP99) ||
+		function(attributes::kFirstValueTimeMax);
+}
+
+auto StartupReader::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	// Try each readable attribute
+	if (attribute == attributes::kPendingInitialReads)
+	{
+		return _dataBlock.member(&State::_pendingReads);
+	}
+	else if (attribute == attributes::kFirstValueTimeMedian)
+	{
+		return _dataBlock.member(&State::_firstValueTimeMedian);
+	}
+	else if (attribute == attributes::kFirstValueTimeP99)
+	{
+		return _dataBlock.member(&State::_firstValueTimeP99);
+	}
+	else if (attribute == attributes::kFirstValueTimeMax)
+	{
+		return _dataBlock.member(&State::_firstValueTimeMax);
+	}
+
+	return std::nullopt;
+}
+
+auto StartupReader::realize() -> void
+{
+	// Create the data block
+	_dataBlock.create(memory::memoryResources::data());
+}
+
+auto StartupReader::start() -> void
+{
+	for (std::size_t index = 0; index < _threadCount; ++index)
+	{
+		_threads.emplace_back([this](std::stop_token stopToken) { run(stopToken); });
+	}
+}
+
+auto StartupReader::stop() -> void
+{
+	// Stop and join all threads. std::jthread requests a stop on destruction, which wakes up the condition variable.
+	_threads.clear();
+
+	// Discard any remaining jobs
+	std::scoped_lock lock { _mutex };
+	_jobs.clear();
+}
+
+auto StartupReader::prepare(Point &point, std::function<Result()> read) -> bool
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	// The startup phase starts with the first initial read
+	auto noStartTime = std::chrono::steady_clock::rep(0);
+	_startTime.compare_exchange_strong(noStartTime, now.time_since_epoch().count(), std::memory_order_relaxed);
+
+	switch (point._state.load(std::memory_order_acquire))
+	{
+	case Point::State::Idle:
+		_pendingReads.fetch_add(1, std::memory_order_relaxed);
+		point._state.store(Point::State::Pending, std::memory_order_release);
+
+		// Without worker threads, just read synchronously. If the result arrives later, we wait for it like for a read
+		// on a worker thread.
+		if (_threads.empty())
+		{
+			perform(point, read);
+			return !point.pending() || deadlineExpired(now);
+		}
+
+		// Hand the read to the worker threads
+		{
+			std::scoped_lock lock { _mutex };
+			_jobs.push_back([this, &point, read = std::move(read)]() { perform(point, read); });
+		}
+		_condition.notify_one();
+		return false;
+
+	case Point::State::Pending:
+		// Give up waiting once the deadline has expired. The read will fill in the value once it completes.
+		return deadlineExpired(now);
+
+	case Point::State::Done:
+	default:
+		return true;
+	}
+}
+
+auto StartupReader::finish(Point &point, bool valid) -> void
+{
+	// Only finish reads that are still in progress, and only once. The load avoids an atomic write for the results of
+	// the reads after the initial one.
+	auto pending = Point::State::Pending;
+	if (point._state.load(std::memory_order_acquire) != pending ||
+		!point._state.compare_exchange_strong(pending, Point::State::Done, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	// Record the time it took to get the first valid value
+	if (valid)
+	{
+		const std::chrono::steady_clock::time_point startTime { std::chrono::steady_clock::duration(_startTime.load(std::memory_order_relaxed)) };
+		_firstValueTimes.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime));
+	}
+
+	const auto remaining = _pendingReads.fetch_sub(1, std::memory_order_acq_rel) - 1;
+	const auto completed = _completedReads.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	// Publish the statistics whenever no reads are outstanding, so the final statistics are always published, and
+	// periodically in between. Without worker threads, this publishes after every read, since the reads are performed
+	// one at a time, and we don't know which one is the last.
+	if (remaining == 0 || completed % kPublishInterval == 1)
+	{
+		publish();
+	}
+}
+
+auto StartupReader::perform(Point &point, const std::function<Result()> &read) -> void
+{
+	// Deferred reads are finished once their result arrives
+	if (const auto result = read(); result != Result::Deferred)
+	{
+		finish(point, result == Result::Valid);
+	}
+}
+
+auto StartupReader::deadlineExpired(std::chrono::steady_clock::time_point now) const noexcept -> bool
+{
+	const std::chrono::steady_clock::time_point startTime { std::chrono::steady_clock::duration(_startTime.load(std::memory_order_relaxed)) };
+	return now - startTime >= _deadline;
+}
+
+auto StartupReader::run(std::stop_token stopToken) -> void
+{
+	for (;;)
+	{
+		// Get the next job
+		std::function<void()> job;
+		{
+			std::unique_lock lock { _mutex };
+			if (!_condition.wait(lock, stopToken, [this] { return !_jobs.empty(); }))
+			{
+				return;
+			}
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+auto StartupReader::publish() -> void
+{
+	std::scoped_lock lock { _publishMutex };
+
+	// Make a write sentinel
+	memory::WriteSentinel sentinel { _dataBlock };
+	auto &state = *sentinel;
+
+	// Update the state
+	state._pendingReads = _pendingReads.load(std::memory_order_relaxed);
+	state._firstValueTimeMedian = std::uint64_t(_firstValueTimes.percentile(0.5).count());
+	state._firstValueTimeP99 = std::uint64_t(_firstValueTimes.percentile(0.99).count());
+	state._firstValueTimeMax = std::uint64_t(_firstValueTimes.maximum().count());
+
+	// Commit the data without raising any events
+	sentinel.commit(std::chrono::system_clock::now(), process::StaticEventList<1> {});
+}
+
+} // namespace xentara::plugins::templateDriver
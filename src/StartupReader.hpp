@@ -0,0 +1,194 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "LatencyHistogram.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/ObjectBlock.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Performs the initial reads of the data points of an I/O component during startup.
+///
+/// If no worker threads are configured, the initial reads are performed synchronously, one data point at a time.
+/// Otherwise, all initial reads are issued concurrently on a pool of worker threads. Data points wait for their
+/// initial read to complete until a configurable startup deadline expires, after which they proceed to the
+/// operational stage with whatever value they have, and the initial read fills in the value once it completes.
+///
+/// The time from the start of the startup phase until each data point received its first valid value is
+/// recorded, and its distribution is published as attributes of the I/O component.
+class StartupReader final
+{
+public:
+	/// @brief The initial read state of a single data point
+	class Point final
+	{
+	public:
+		/// @brief Returns whether the initial read is still in progress.
+		///
+		/// Data points must not perform any other reads while this is the case.
+		auto pending() const noexcept -> bool
+		{
+			return _state.load(std::memory_order_acquire) == State::Pending;
+		}
+
+	private:
+		/// @brief The startup reader manages the state
+		friend class StartupReader;
+
+		/// @brief The possible states
+		enum class State
+		{
+			/// @brief The initial read has not been started yet
+			Idle,
+			/// @brief The initial read is in progress
+			Pending,
+			/// @brief The initial read has completed
+			Done
+		};
+
+		/// @brief The current state
+		std::atomic<State> _state { State::Idle };
+	};
+
+	/// @brief The result of an initial read
+	enum class Result
+	{
+		/// @brief A valid value was read
+		Valid,
+		/// @brief The read failed
+		Invalid,
+		/// @brief The read was sent, and its result will be passed to finish() once it arrives
+		Deferred
+	};
+
+	/// @brief Sets the number of worker threads. 0 performs the initial reads synchronously.
+	auto setThreadCount(std::size_t threadCount) noexcept -> void
+	{
+		_threadCount = threadCount;
+	}
+
+	/// @brief Returns whether the initial reads are performed on worker threads
+	auto threaded() const noexcept -> bool
+	{
+		return _threadCount != 0;
+	}
+
+	/// @brief Sets the maximum time data points wait for their initial read to complete
+	auto setDeadline(std::chrono::nanoseconds deadline) noexcept -> void
+	{
+		_deadline = deadline;
+	}
+
+	/// @brief Iterates over all the attributes that belong to the startup reader.
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Creates a read-handle for an attribute that belong to the startup reader.
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown
+	auto makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>;
+
+	/// @brief Realizes the startup reader
+	auto realize() -> void;
+
+	/// @brief Starts the worker threads, if any
+	auto start() -> void;
+
+	/// @brief Stops the worker threads and discards any initial reads that have not been started yet
+	auto stop() -> void;
+
+	/// @brief Prepares the initial read of a data point.
+	///
+	/// This function must be called repeatedly from the data point's "read" task until it returns true.
+	/// @param point The initial read state of the data point
+	/// @param read A function that performs the read, and returns its result
+	/// @return Whether the data point may proceed to the next stage
+	auto prepare(Point &point, std::function<Result()> read) -> bool;
+
+	/// @brief Finishes an initial read whose result arrived later
+	///
+	/// This function may be called for every result of a deferred read. It does nothing unless the initial read of the data
+	/// point is still in progress.
+	/// @param point The initial read state of the data point
+	/// @param valid Whether a valid value was read
+	auto finish(Point &point, bool valid) -> void;
+
+	/// @brief Returns the distribution of the times it took for the data points to receive their first valid value
+	auto firstValueTimes() const noexcept -> const LatencyHistogram &
+	{
+		return _firstValueTimes;
+	}
+
+private:
+	/// @brief This structure is used to represent the state inside the memory block
+	struct State final
+	{
+		/// @brief The number of initial reads that have not completed yet
+		std::uint64_t _pendingReads { 0 };
+		/// @brief The median time until a data point received its first valid value, in nanoseconds
+		std::uint64_t _firstValueTimeMedian { 0 };
+		/// @brief The 99th percentile of the time until a data point received its first valid value, in nanoseconds
+		std::uint64_t _firstValueTimeP99 { 0 };
+		/// @brief The longest time until a data point received its first valid value, in nanoseconds
+		std::uint64_t _firstValueTimeMax { 0 };
+	};
+
+	/// @brief Performs an initial read and records the result, unless it is deferred
+	auto perform(Point &point, const std::function<Result()> &read) -> void;
+
+	/// @brief Returns whether the startup deadline has expired
+	auto deadlineExpired(std::chrono::steady_clock::time_point now) const noexcept -> bool;
+
+	/// @brief The main function of the worker threads
+	auto run(std::stop_token stopToken) -> void;
+
+	/// @brief Publishes the current statistics
+	auto publish() -> void;
+
+	/// @brief The number of worker threads
+	std::size_t _threadCount { 0 };
+	/// @brief The startup deadline
+	std::chrono::nanoseconds _deadline { std::chrono::nanoseconds::max() };
+
+	/// @brief The time the first initial read was requested, in steady clock ticks, or 0 if none was requested yet
+	std::atomic<std::chrono::steady_clock::rep> _startTime { 0 };
+	/// @brief The number of initial reads that have not completed yet
+	std::atomic<std::uint64_t> _pendingReads { 0 };
+	/// @brief The number of initial reads that have completed
+	std::atomic<std::uint64_t> _completedReads { 0 };
+	/// @brief The time it took the data points to receive their first valid value
+	LatencyHistogram _firstValueTimes;
+
+	/// @brief The mutex protecting the job queue
+	std::mutex _mutex;
+	/// @brief The condition variable used to wake up the worker threads
+	std::condition_variable_any _condition;
+	/// @brief The initial reads that have not been started yet
+	std::deque<std::function<void()>> _jobs;
+	/// @brief The worker threads
+	std::vector<std::jthread> _threads;
+
+	/// @brief A mutex serializing commits to the data block, which may happen from different worker threads
+	std::mutex _publishMutex;
+	/// @brief The data block that contains the state
+	memory::ObjectBlock<State> _dataBlock;
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,113 @@
+// Copyright (c) embedded ocean GmbH
+#include "TaskTiming.hpp"
+
+#include "ExecutionTrace.hpp"
+
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/process/EventList.hpp>
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+namespace
+{
+
+	/// @brief How often the results are published
+	constexpr auto kPublishInterval = 1s;
+
+} // namespace
+
+auto TaskTiming::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support
+	return
+		function(*_attributes._startDelayP99) ||
+		function(*_attributes._startDelayMax) ||
+		function(*_attributes._executionTimeP99) ||
+		function(*_attributes._executionTimeMax) ||
+		function(*_attributes._overruns);
+}
+
+auto TaskTiming::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	// Try each readable attribute
+	if (attribute == *_attributes._startDelayP99)
+	{
+		return _dataBlock.member(&State::_startDelayP99);
+	}
+	else if (attribute == *_attributes._startDelayMax)
+	{
+		return _dataBlock.member(&State::_startDelayMax);
+	}
+	else if (attribute == *_attributes._executionTimeP99)
+	{
+		return _dataBlock.member(&State::_executionTimeP99);
+	}
+	else if (attribute == *_attributes._executionTimeMax)
+	{
+		return _dataBlock.member(&State::_executionTimeMax);
+	}
+	else if (attribute == *_attributes._overruns)
+	{
+		return _dataBlock.member(&State::_overruns);
+	}
+
+	return std::nullopt;
+}
+
+auto TaskTiming::realize() -> void
+{
+	// Create the data block
+	_dataBlock.create(memory::memoryResources::data());
+}
+
+auto TaskTiming::record(std::chrono::system_clock::time_point scheduledTime,
+	std::chrono::system_clock::time_point startTime,
+	std::chrono::steady_clock::duration executionTime) -> void
+{
+	const auto startDelay = std::chrono::duration_cast<std::chrono::nanoseconds>(startTime - scheduledTime);
+	const auto executionNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(executionTime);
+
+	_startDelays.record(startDelay);
+	_executionTimes.record(executionNanoseconds);
+
+	// Check if we finished after the next cycle was due. We can only tell the cycle time from the second invocation on.
+	if (_lastScheduledTime && scheduledTime > *_lastScheduledTime &&
+		startDelay + executionNanoseconds > scheduledTime - *_lastScheduledTime)
+	{
+		++_overruns;
+
+		// Capture the trace leading up to the overrun, if requested
+		ExecutionTrace::overrunDetected();
+	}
+	_lastScheduledTime = scheduledTime;
+
+	// Publish the results periodically
+	if (!_lastPublishTime || scheduledTime - *_lastPublishTime >= kPublishInterval)
+	{
+		publish(scheduledTime);
+		_lastPublishTime = scheduledTime;
+	}
+}
+
+auto TaskTiming::publish(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Make a write sentinel
+	memory::WriteSentinel sentinel { _dataBlock };
+	auto &state = *sentinel;
+
+	// Update the state
+	state._startDelayP99 = std::uint64_t(_startDelays.percentile(0.99).count());
+	state._startDelayMax = std::uint64_t(_startDelays.maximum().count());
+	state._executionTimeP99 = std::uint64_t(_executionTimes.percentile(0.99).count());
+	state._executionTimeMax = std::uint64_t(_executionTimes.maximum().count());
+	state._overruns = _overruns;
+
+	// Commit the data without raising any events
+	sentinel.commit(timeStamp, process::StaticEventList<1> {});
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,134 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "LatencyHistogram.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/ObjectBlock.hpp>
+#include <xentara/model/Attribute.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/process/ExecutionContext.hpp>
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Measures how late a task runs relative to its scheduled time, and how long it takes.
+///
+/// The start delay and execution time of each invocation are recorded in lock-free histograms. An invocation counts
+/// as a cycle overrun if it did not finish before the next cycle was due, with the cycle time taken as the distance
+/// between the scheduled times of the last two invocations.
+///
+/// The results are published as attributes about once a second, so that the measurement does not add a commit to
+/// each invocation.
+class TaskTiming final
+{
+public:
+	/// @brief The attributes the results are published under
+	struct AttributeSet final
+	{
+		/// @brief The attribute for the 99th percentile of the start delay
+		const model::Attribute *_startDelayP99;
+		/// @brief The attribute for the maximum start delay
+		const model::Attribute *_startDelayMax;
+		/// @brief The attribute for the 99th percentile of the execution time
+		const model::Attribute *_executionTimeP99;
+		/// @brief The attribute for the maximum execution time
+		const model::Attribute *_executionTimeMax;
+		/// @brief The attribute for the number of cycle overruns
+		const model::Attribute *_overruns;
+	};
+
+	/// @brief Constructor
+	/// @param attributes The attributes the results are published under
+	constexpr explicit TaskTiming(const AttributeSet &attributes) noexcept : _attributes(attributes)
+	{
+	}
+
+	/// @brief Iterates over all the attributes that belong to the timing information.
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Creates a read-handle for an attribute that belong to the timing information.
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown
+	auto makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>;
+
+	/// @brief Realizes the timing information
+	auto realize() -> void;
+
+	/// @brief Executes a function and records its timing
+	/// @param context The execution context of the task invocation
+	/// @param function The function to execute
+	template <std::invocable Function>
+	auto measure(const process::ExecutionContext &context, Function &&function) -> void
+	{
+		const auto startTime = std::chrono::system_clock::now();
+		const auto executionStart = std::chrono::steady_clock::now();
+
+		function();
+
+		record(context.scheduledTime(), startTime, std::chrono::steady_clock::now() - executionStart);
+	}
+
+	/// @brief Returns the distribution of the start delays
+	auto startDelays() const noexcept -> const LatencyHistogram &
+	{
+		return _startDelays;
+	}
+
+	/// @brief Returns the distribution of the execution times
+	auto executionTimes() const noexcept -> const LatencyHistogram &
+	{
+		return _executionTimes;
+	}
+
+private:
+	/// @brief This structure is used to represent the state inside the memory block
+	struct State final
+	{
+		/// @brief The 99th percentile of the start delay, in nanoseconds
+		std::uint64_t _startDelayP99 { 0 };
+		/// @brief The maximum start delay, in nanoseconds
+		std::uint64_t _startDelayMax { 0 };
+		/// @brief The 99th percentile of the execution time, in nanoseconds
+		std::uint64_t _executionTimeP99 { 0 };
+		/// @brief The maximum execution time, in nanoseconds
+		std::uint64_t _executionTimeMax { 0 };
+		/// @brief The number of cycle overruns
+		std::uint64_t _overruns { 0 };
+	};
+
+	/// @brief Records the timing of an invocation
+	auto record(std::chrono::system_clock::time_point scheduledTime,
+		std::chrono::system_clock::time_point startTime,
+		std::chrono::steady_clock::duration executionTime) -> void;
+
+	/// @brief Publishes the current results
+	auto publish(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief The attributes the results are published under
+	AttributeSet _attributes;
+
+	/// @brief The start delays
+	LatencyHistogram _startDelays;
+	/// @brief The execution times
+	LatencyHistogram _executionTimes;
+	/// @brief The number of cycle overruns
+	std::uint64_t _overruns { 0 };
+
+	/// @brief The scheduled time of the last invocation, if any
+	std::optional<std::chrono::system_clock::time_point> _lastScheduledTime;
+	/// @brief The scheduled time of the invocation the results were last published at, if any
+	std::optional<std::chrono::system_clock::time_point> _lastPublishTime;
+
+	/// @brief The data block that contains the state
+	memory::ObjectBlock<State> _dataBlock;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -17,4 +17,10 @@ const process::Task::Role kRead { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "
 /// @todo assign a unique UUID
 const process::Task::Role kWrite { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "write"sv };
 
+/// @todo assign a unique UUID
+const process::Task::Role kCheckpoint { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "checkpoint"sv };
+
+/// @todo assign a unique UUID
+const process::Task::Role kMonitor { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "monitor"sv };
+
 } // namespace xentara::plugins::templateDriver::tasks
\ No newline at end of file
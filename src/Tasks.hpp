@@ -11,5 +11,9 @@ namespace xentara::plugins::templateDriver::tasks
 extern const process::Task::Role kRead;
 /// @brief A Xentara task used to write a data point
 extern const process::Task::Role kWrite;
+/// @brief A Xentara task used to save the last valid values of all data points of an I/O component
+extern const process::Task::Role kCheckpoint;
+/// @brief A Xentara task used to downgrade the quality of data points of an I/O component that were not updated in time
+extern const process::Task::Role kMonitor;
 
 } // namespace xentara::plugins::templateDriver::tasks
\ No newline at end of file
@@ -2,20 +2,35 @@
 #include "TemplateInput.hpp"
 
 #include "Attributes.hpp"
+#include "CustomError.hpp"
+#include "ExecutionTrace.hpp"
+#include "Reactor.hpp"
+#include "SampleStatistics.hpp"
 #include "Tasks.hpp"
+#include "TemplateIoComponent.hpp"
+#include "TimeoutWheel.hpp"
 
 #include <xentara/config/Errors.hpp>
 #include <xentara/data/DataType.hpp>
+#include <xentara/data/Quality.hpp>
 #include <xentara/data/ReadHandle.hpp>
 #include <xentara/model/Attribute.hpp>
 #include <xentara/model/ForEachAttributeFunction.hpp>
 #include <xentara/model/ForEachEventFunction.hpp>
 #include <xentara/model/ForEachTaskFunction.hpp>
 #include <xentara/process/ExecutionContext.hpp>
+#include <xentara/utils/json/decoder/Array.hpp>
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
 #include <xentara/utils/eh/currentErrorCode.hpp>
 
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+
 namespace xentara::plugins::templateDriver
 {
 	
@@ -25,6 +40,27 @@ const model::Attribute TemplateInput::kValueAttribute { model::Attribute::kValue
 
 auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
+	// The update timeout is only enabled at the end, once we know the quality
+	std::chrono::milliseconds updateTimeout { 0 };
+	auto timeoutQuality = data::Quality::Uncertain;
+	// The adaptive polling parameters are also only used at the end
+	std::chrono::milliseconds minPollInterval { 0 };
+	std::optional<std::chrono::milliseconds> maxPollInterval;
+	double pollDeadBand { 0.0 };
+	// The scaling is assembled at the end as well
+	std::optional<std::array<double, 4>> scalingCoefficients;
+	auto clampLow = -std::numeric_limits<double>::infinity();
+	auto clampHigh = std::numeric_limits<double>::infinity();
+	// The bit field is checked at the end as well
+	std::optional<unsigned> firstBit;
+	std::optional<unsigned> bitCount;
+	// The limits are checked at the end as well
+	LimitMonitor::Limits limits;
+	bool hasLimits = false;
+	double limitDeadBand { 0.0 };
+	std::chrono::milliseconds limitOnDelay { 0 };
+	std::chrono::milliseconds limitOffDelay { 0 };
+
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
@@ -43,6 +79,208 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 
 			/// @todo set the appropriate member variables
 		}
+		else if (name == "updateTimeout"sv)
+		{
+			updateTimeout = std::chrono::milliseconds(value.asNumber<std::uint64_t>());
+
+			// Check that the value is valid
+			if (updateTimeout == std::chrono::milliseconds::zero())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("update timeout of zero for template input"));
+			}
+		}
+		else if (name == "timeoutQuality"sv)
+		{
+			const auto quality = TimeoutWheel::parseQuality(value.asString<std::string>());
+
+			// Check that the value is valid
+			if (!quality)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown timeout quality for template input, must be \"uncertain\" or \"bad\""));
+			}
+
+			timeoutQuality = *quality;
+		}
+		else if (name == "priority"sv)
+		{
+			const auto priority = CycleBudget::parsePriority(value.asString<std::string>());
+
+			// Check that the value is valid
+			if (!priority)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown priority for template input, must be \"low\", \"normal\" or \"critical\""));
+			}
+
+			_loadShedding.setPriority(*priority);
+		}
+		else if (name == "minPollInterval"sv)
+		{
+			minPollInterval = std::chrono::milliseconds(value.asNumber<std::uint64_t>());
+		}
+		else if (name == "maxPollInterval"sv)
+		{
+			maxPollInterval = std::chrono::milliseconds(value.asNumber<std::uint64_t>());
+
+			// Check that the value is valid
+			if (*maxPollInterval == std::chrono::milliseconds::zero())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("maximum poll interval of zero for template input"));
+			}
+		}
+		else if (name == "pollDeadBand"sv)
+		{
+			pollDeadBand = value.asNumber<double>();
+
+			// Check that the value is valid
+			if (!(pollDeadBand >= 0))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("negative poll dead band for template input"));
+			}
+		}
+		else if (name == "notificationFile"sv)
+		{
+			_notificationPath = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (_notificationPath.empty())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("empty notification file name for template input"));
+			}
+			if (!Reactor::kSupported)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("push mode is not supported for template input on this system"));
+			}
+		}
+		else if (name == "group"sv)
+		{
+			const auto groupName = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (groupName.empty())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("empty group name for template input"));
+			}
+
+			_group = &_ioComponent.get().pointGroup(groupName);
+		}
+		else if (name == "register"sv)
+		{
+			_register = value.asNumber<std::size_t>();
+		}
+		else if (name == "bit"sv)
+		{
+			firstBit = value.asNumber<unsigned>();
+
+			// Check that the value is valid
+			if (*firstBit >= 16)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("bit of template input must be between 0 and 15"));
+			}
+		}
+		else if (name == "bitCount"sv)
+		{
+			bitCount = value.asNumber<unsigned>();
+
+			// Check that the value is valid
+			if (*bitCount == 0 || *bitCount > 16)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("bit count of template input must be between 1 and 16"));
+			}
+		}
+		else if (name == "oversampling"sv)
+		{
+			auto oversampling = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (oversampling == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("oversampling factor of template input must be at least 1"));
+			}
+
+			_oversampling = oversampling;
+		}
+		else if (name == "historyBlocks"sv)
+		{
+			auto blocks = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (blocks < 2)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("history of template input must have at least 2 blocks"));
+			}
+
+			_state.enableHistory(blocks);
+		}
+		else if (name == "scaling"sv)
+		{
+			// The scaling is a polynomial, given as its coefficients, lowest order first
+			std::array<double, 4> coefficients {};
+			std::size_t count = 0;
+			for (auto &&coefficient : value.asArray())
+			{
+				// Check that the value is valid
+				if (count == coefficients.size())
+				{
+					utils::json::decoder::throwWithLocation(value, std::runtime_error("scaling of template input can have at most 4 coefficients"));
+				}
+
+				coefficients[count++] = coefficient.asNumber<double>();
+			}
+
+			// Check that the value is valid
+			if (count == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("scaling of template input must have at least one coefficient"));
+			}
+
+			scalingCoefficients = coefficients;
+		}
+		else if (name == "clampLow"sv)
+		{
+			clampLow = value.asNumber<double>();
+		}
+		else if (name == "clampHigh"sv)
+		{
+			clampHigh = value.asNumber<double>();
+		}
+		else if (name == "lowLowLimit"sv)
+		{
+			limits._lowLow = value.asNumber<double>();
+			hasLimits = true;
+		}
+		else if (name == "lowLimit"sv)
+		{
+			limits._low = value.asNumber<double>();
+			hasLimits = true;
+		}
+		else if (name == "highLimit"sv)
+		{
+			limits._high = value.asNumber<double>();
+			hasLimits = true;
+		}
+		else if (name == "highHighLimit"sv)
+		{
+			limits._highHigh = value.asNumber<double>();
+			hasLimits = true;
+		}
+		else if (name == "limitDeadBand"sv)
+		{
+			limitDeadBand = value.asNumber<double>();
+
+			// Check that the value is valid
+			if (!(limitDeadBand >= 0))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("negative limit dead band for template input"));
+			}
+		}
+		else if (name == "limitOnDelay"sv)
+		{
+			limitOnDelay = std::chrono::milliseconds(value.asNumber<std::uint64_t>());
+		}
+		else if (name == "limitOffDelay"sv)
+		{
+			limitOffDelay = std::chrono::milliseconds(value.asNumber<std::uint64_t>());
+		}
 		else
 		{
             config::throwUnknownParameterError(name);
@@ -55,40 +293,352 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 		/// @todo use an error message that tells the user exactly what is wrong
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("TODO is wrong with template input"));
 	}
+
+	// Map the input to a bit field of a register, if requested
+	if (_register)
+	{
+		// Check that the field fits into the register
+		_firstBit = firstBit.value_or(0);
+		_bitCount = bitCount.value_or(1);
+		if (_firstBit + _bitCount > 16)
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("bit field of template input does not fit into a 16-bit register"));
+		}
+
+		// Inputs mapped to registers are read by the I/O component
+		if (!_notificationPath.empty())
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template input cannot be mapped to a register in push mode"));
+		}
+
+		// Inputs mapped to registers are only updated when their bits change, so their update time stamp says nothing
+		// about whether the registers are still being read
+		if (updateTimeout != std::chrono::milliseconds::zero())
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template input mapped to a register cannot have an update timeout"));
+		}
+	}
+	else if (firstBit || bitCount)
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template input has a bit field, but no register"));
+	}
+
+	// In push mode, a single value is read for each notification
+	if (!_notificationPath.empty() && _oversampling > 1)
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template input in push mode cannot use oversampling"));
+	}
+
+	// Inputs in a group are read together with the other inputs of the group
+	if (_group && (!_notificationPath.empty() || _register || maxPollInterval || _oversampling > 1))
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template input in a group cannot use push mode, registers, adaptive polling or oversampling"));
+	}
+
+	// Join the group. This must be done while loading, because the I/O component realizes the group before the inputs
+	// are realized, and the group needs to know all its members to create its data block.
+	if (_group)
+	{
+		_group->add(_state);
+	}
+
+	// Make the polling rate adaptive, if requested
+	if (maxPollInterval)
+	{
+		// Check that the intervals are consistent
+		if (minPollInterval >= *maxPollInterval)
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("minimum poll interval of template input must be shorter than the maximum poll interval"));
+		}
+
+		_adaptivePolling.emplace(minPollInterval, *maxPollInterval, pollDeadBand);
+		_state.attachAdaptivePolling(*_adaptivePolling);
+	}
+	else if (minPollInterval != std::chrono::milliseconds::zero())
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("minimum poll interval of template input requires a maximum poll interval"));
+	}
+
+	// Check the value against limits, if requested
+	if (hasLimits)
+	{
+		// The high-high and low-low limits are the second level of violation, so they need the first level. Limits that
+		// were left out are infinite.
+		if (!std::isinf(limits._highHigh) && std::isinf(limits._high))
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("highHighLimit of template input requires highLimit"));
+		}
+		if (!std::isinf(limits._lowLow) && std::isinf(limits._low))
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("lowLowLimit of template input requires lowLimit"));
+		}
+
+		// Check that the limits are in ascending order. Limits that were left out never fail this check.
+		if (!(limits._lowLow <= limits._low && limits._low < limits._high && limits._high <= limits._highHigh))
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("limits of template input must be in ascending order from low-low to high-high"));
+		}
+
+		_limitMonitor.emplace(limits, limitDeadBand, limitOnDelay, limitOffDelay);
+		_state.attachLimitMonitor(*_limitMonitor);
+	}
+	else if (limitDeadBand != 0 || limitOnDelay != std::chrono::milliseconds::zero() || limitOffDelay != std::chrono::milliseconds::zero())
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("limit dead band and delays of template input require at least one limit"));
+	}
+
+	// Enable the update timeout, if requested
+	if (updateTimeout != std::chrono::milliseconds::zero())
+	{
+		_state.enableUpdateTimeout(updateTimeout, timeoutQuality);
+	}
+
+	// Scale and clamp the value, if requested
+	if (scalingCoefficients || clampLow > -std::numeric_limits<double>::infinity() || clampHigh < std::numeric_limits<double>::infinity())
+	{
+		// Check that the range is consistent
+		if (!(clampLow <= clampHigh))
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("lower clamp limit of template input must not be higher than the upper clamp limit"));
+		}
+
+		_scaling.emplace();
+		if (scalingCoefficients)
+		{
+			_scaling->_coefficients = *scalingCoefficients;
+		}
+		_scaling->_minimum = clampLow;
+		_scaling->_maximum = clampHigh;
+	}
+
+	// Publish the statistics if the input is oversampled
+	if (_oversampling > 1)
+	{
+		_state.enableStatistics();
+	}
 }
 
 auto TemplateInput::performReadTask(const process::ExecutionContext &context) -> void
 {
-	// Read the data
+	const ExecutionTrace::Scope trace { ExecutionTrace::Span::ReadTask, _pointIndex };
+
+	// Don't read anything once the data points have been invalidated
+	const AcquisitionGate::Pass pass(_ioComponent.get().acquisitionGate());
+	if (!pass)
+	{
+		return;
+	}
+
+	// Don't read anything while the initial read is still in progress
+	if (_initialRead.pending())
+	{
+		return;
+	}
+
+	// In push mode, the value is read when the notification arrives, and inputs mapped to registers are read by the
+	// I/O component
+	if (!_notificationPath.empty() || _register)
+	{
+		return;
+	}
+
+	// Inputs in a group are read together, by the "read" task of the first input of the group
+	if (_group)
+	{
+		if (_group->leader() == &_state)
+		{
+			_ioComponent.get().readGroup(*_group, context.scheduledTime());
+		}
+		return;
+	}
+
+	// Skip the read if the value is polled adaptively, and the read is not due yet
+	if (_adaptivePolling && !_adaptivePolling->due(context.scheduledTime()))
+	{
+		return;
+	}
+
+	// Defer the read if the I/O component is over its cycle budget
+	auto &cycleBudget = _ioComponent.get().cycleBudget();
+	if (!cycleBudget.enabled())
+	{
+		read(context.scheduledTime());
+		return;
+	}
+	if (!cycleBudget.admit(_loadShedding, context.scheduledTime()))
+	{
+		_state.markStale(context.scheduledTime());
+		return;
+	}
+
+	// Read the data, and charge the time it took to the cycle
+	const auto readStart = std::chrono::steady_clock::now();
 	read(context.scheduledTime());
+	cycleBudget.charge(context.scheduledTime(), std::chrono::steady_clock::now() - readStart);
+}
+
+auto TemplateInput::prepareInitialRead(const process::ExecutionContext &context) -> bool
+{
+	// Don't read anything if the data points have already been invalidated
+	const AcquisitionGate::Pass pass(_ioComponent.get().acquisitionGate());
+	if (!pass)
+	{
+		return true;
+	}
+
+	// Inputs mapped to registers are read by the "read" task of the I/O component
+	if (_register)
+	{
+		return true;
+	}
+
+	// The first input of a group reads the whole group
+	if (_group)
+	{
+		if (_group->leader() == &_state)
+		{
+			_ioComponent.get().readGroup(*_group, std::chrono::system_clock::now());
+		}
+		return true;
+	}
+
+	return _ioComponent.get().startupReader().prepare(_initialRead, [this]() {
+		read(std::chrono::system_clock::now());
+
+		// With pipelined requests, the initial read is finished by the I/O component when the response arrives
+		if (_ioComponent.get().readsDeferred())
+		{
+			return StartupReader::Result::Deferred;
+		}
+		return _state.currentValue() ? StartupReader::Result::Valid : StartupReader::Result::Invalid;
+	});
 }
 
 auto TemplateInput::read(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	try
+	auto &ioComponent = _ioComponent.get();
+
+	// If we are replaying a recording, take the result from the recording instead of the I/O component
+	if (auto replayer = ioComponent.replayer())
+	{
+		// The recording contains one record per sample
+		const auto samples = replayer->nextSamples(_pointIndex, _oversampling);
+		if (samples.empty())
+		{
+			return;
+		}
+
+		SampleStatistics statistics;
+		for (const auto &sample : samples)
+		{
+			// A failed sample fails the whole read, just like when reading from the I/O component
+			if (const auto error = sample.error())
+			{
+				_state.update(timeStamp, utils::eh::unexpected(error));
+				return;
+			}
+
+			// Recordings contain the raw values, so they must be scaled
+			statistics.add(_scaling ? ScalingTable::scale(*_scaling, sample._value) : sample._value);
+		}
+
+		_state.update(timeStamp, statistics.last(), &statistics);
+		return;
+	}
+
+	// If we are using the shared memory transport, take the values from the shared memory ring. This updates all the data
+	// points the producer sent values for, not just this one.
+	if (auto transport = ioComponent.sharedMemoryTransport())
+	{
+		transport->receive(timeStamp);
+		return;
+	}
+
+	// If we are using pipelined requests, just send the request. The state is updated once the response arrives.
+	if (ioComponent.pipelined())
+	{
+		ioComponent.requestRead(_pointIndex, timeStamp);
+		return;
+	}
+
+	// Get the recorder, if we are recording
+	const auto recorder = ioComponent.recorder();
+
+	// Take all the samples for this interval. This does not allocate any memory, so it is safe to do in a tight loop. The
+	// statistics are kept on the stack, because in push mode, the initial read and the reactor thread may read at the
+	// same time.
+	SampleStatistics statistics;
+	for (std::size_t sample = 0; sample < _oversampling; ++sample)
 	{
-		/// @todo read the value
+		const auto sampleStart = recorder ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
 		double value = {};
+		std::error_code error;
+		{
+			const ExecutionTrace::Scope trace { ExecutionTrace::Span::DeviceRead, _pointIndex };
 
-		/// @todo if the read function does not throw errors, but uses return types or internal handle state,
-		// throw an std::system_error here on failure, or call _state.update() directly.
+			/// @todo read the value, and set error if the read failed
+			value = {};
+
+			/// @todo if the read function throws exceptions, catch them here and use utils::eh::currentErrorCode() to
+			// get the error. Note that exceptions allocate memory, so this will abort the driver if it was built to verify
+			// that this cyclic path does not allocate memory.
+		}
 
-		// The read was successful
-		_state.update(timeStamp, value);
+		// A failed sample fails the whole read
+		if (error)
+		{
+			// Record the error, if requested
+			if (recorder)
+			{
+				recorder->recordRead(_pointIndex, sampleStart, utils::eh::unexpected(error));
+			}
+			// Update the state
+			_state.update(timeStamp, utils::eh::unexpected(error));
+			return;
+		}
+
+		// Record the raw result, if requested
+		if (recorder)
+		{
+			recorder->recordRead(_pointIndex, sampleStart, value);
+		}
+
+		// Convert the value into engineering units
+		if (_scaling)
+		{
+			value = ScalingTable::scale(*_scaling, value);
+		}
+
+		statistics.add(value);
 	}
-	catch (const std::exception &)
+
+	// The read was successful. The last sample becomes the value, and the statistics are published along with it.
+	_state.update(timeStamp, statistics.last(), &statistics);
+}
+
+auto TemplateInput::handleNotification(int fileDescriptor, std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void
+{
+	// Report errors of the notification file
+	if (error)
 	{
-		// Get the error from the current exception using this special utility function
-		const auto error = utils::eh::currentErrorCode();
-		// Update the state
 		_state.update(timeStamp, utils::eh::unexpected(error));
+		return;
 	}
+
+	// Consume the notification
+	/// @todo if the notification carries the data itself, like an IIO buffer or a socket message, decode the value
+	// from the data instead of discarding it
+	Reactor::drain(fileDescriptor);
+
+	// Read the value, using the arrival time of the notification as time stamp
+	read(timeStamp);
 }
 
 auto TemplateInput::invalidateData(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	// Set the state to "No Data"
-	_state.update(timeStamp, utils::eh::unexpected(CustomError::NoData));
+	// The I/O component invalidates all its data points at once
+	_ioComponent.get().invalidatePoints(timeStamp);
 }
 
 auto TemplateInput::dataType() const -> const data::DataType &
@@ -108,7 +658,10 @@ auto TemplateInput::forEachAttribute(const model::ForEachAttributeFunction &func
 		function(kValueAttribute) ||
 
 		// Handle the state attributes
-		_state.forEachAttribute(function);
+		_state.forEachAttribute(function) ||
+
+		// Handle the task timing attributes
+		_readTask.timing().forEachAttribute(function);
 
 	/// @todo handle any additional attributes this class supports, including attributes inherited from the I/O component
 }
@@ -145,6 +698,12 @@ auto TemplateInput::makeReadHandle(const model::Attribute &attribute) const noex
 		return handle;
 	}
 
+	// Handle the task timing attributes
+	if (auto handle = _readTask.timing().makeReadHandle(attribute))
+	{
+		return handle;
+	}
+
 	/// @todo handle any additional readable attributes this class supports, including attributes inherited from the I/O component
 
 	return std::nullopt;
@@ -152,8 +711,44 @@ auto TemplateInput::makeReadHandle(const model::Attribute &attribute) const noex
 
 auto TemplateInput::realize() -> void
 {
+	// Register with the I/O component. This must be done before realizing the state, because the I/O component
+	// decides how the state is stored.
+	_pointIndex = _ioComponent.get().registerPoint(_state, primaryKey(), _initialRead);
+
 	// Realize the state object
-	_state.realize();
+	_state.realize(sharedFromThis());
+	// Realize the task timing information
+	_readTask.timing().realize();
+
+	// Let the I/O component scale values it receives for us in blocks
+	if (_scaling)
+	{
+		_ioComponent.get().scaling().set(_pointIndex, *_scaling);
+	}
+
+	// Have the I/O component decode our value from its register image
+	if (_register)
+	{
+		_ioComponent.get().registerImage().addField(_pointIndex, *_register, _firstBit, _bitCount);
+	}
+
+	// Let the I/O component know if we are read using pipelined requests, so that we are marked as not connected when
+	// the connection to the server is lost
+	if (_ioComponent.get().pipelined() && !_register && !_group && _notificationPath.empty())
+	{
+		_ioComponent.get().addPipelinedPoint(_pointIndex);
+	}
+
+	// Have the reactor of the I/O component wait for notifications in push mode. The state is then updated from
+	// the reactor thread as well as from the "read" task, which performs the initial read.
+	if (!_notificationPath.empty())
+	{
+		_state.enableConcurrentUpdates();
+		_ioComponent.get().reactor().add(_notificationPath,
+			[this](int fileDescriptor, std::chrono::system_clock::time_point timeStamp, std::error_code error) {
+				handleNotification(fileDescriptor, timeStamp, error);
+			});
+	}
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -1,15 +1,25 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "AdaptivePolling.hpp"
+#include "LimitMonitor.hpp"
 #include "ReadState.hpp"
+#include "CycleBudget.hpp"
 #include "ReadTask.hpp"
+#include "StartupReader.hpp"
+#include "ScalingTable.hpp"
 
 #include <xentara/process/Task.hpp>
 #include <xentara/skill/DataPoint.hpp>
 #include <xentara/skill/EnableSharedFromThis.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
 #include <functional>
+#include <optional>
 #include <string_view>
+#include <system_error>
 
 namespace xentara::plugins::templateDriver
 {
@@ -52,6 +62,12 @@ public:
 
 	/// @}
 
+	/// @brief Returns the in-memory history of the value, or nullptr if it is not enabled
+	auto history() const noexcept -> const CompressedHistory *
+	{
+		return _state.history();
+	}
+
 	/// @brief A Xentara attribute containing the current value.
 	/// @note This is a member of this class rather than of the attributes namespace, because the access flags
 	/// and type may differ from class to class
@@ -65,10 +81,19 @@ private:
 	///
 	/// This function attempts to read the value if the I/O component is up.
 	auto performReadTask(const process::ExecutionContext &context) -> void;
+	/// @brief This function is called by the "read" task to perform the initial read.
+	/// @return Whether the initial read is done, or the startup deadline has expired
+	auto prepareInitialRead(const process::ExecutionContext &context) -> bool;
 	/// @brief Attempts to read the data from the I/O component and updates the state accordingly.
 	auto read(std::chrono::system_clock::time_point timeStamp) -> void;
 
-	/// @brief Invalidates any read data
+	/// @brief This function is called by the reactor of the I/O component when the notification file becomes readable
+	/// @param fileDescriptor The file descriptor of the notification file
+	/// @param timeStamp The time the notification arrived, which is used as acquisition time stamp
+	/// @param error The error, if the notification file failed
+	auto handleNotification(int fileDescriptor, std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void;
+
+	/// @brief Invalidates any read data, along with the data of all other data points of the I/O component
 	auto invalidateData(std::chrono::system_clock::time_point timeStamp) -> void;
 
 	/// @name Virtual Overrides for skill::DataPoint
@@ -83,11 +108,45 @@ private:
 	/// @brief The I/O component this input belongs to
 	/// @todo give this a more descriptive name, e.g. "_device"
 	std::reference_wrapper<TemplateIoComponent> _ioComponent;
+	/// @brief The index of this data point within the I/O component
+	std::size_t _pointIndex { 0 };
+
+	/// @brief The path of the file that notifies us of new data in push mode, or an empty path to poll the value
+	std::filesystem::path _notificationPath;
+
+	/// @brief The group the input is read and committed with, or nullptr if it is read on its own
+	/// @todo use the correct value type
+	ReadState<double>::Group *_group { nullptr };
+
+	/// @brief The index of the register of the I/O component the input is mapped to, or std::nullopt to read the value
+	/// using an individual command
+	std::optional<std::size_t> _register;
+	/// @brief The lowest bit of the field within the register
+	unsigned _firstBit { 0 };
+	/// @brief The number of bits in the field
+	unsigned _bitCount { 1 };
+
+	/// @brief The number of times the value is sampled each time the "read" task is executed
+	std::size_t _oversampling { 1 };
+
+	/// @brief The object that adapts the polling rate, if the polling rate is adaptive
+	std::optional<AdaptivePolling> _adaptivePolling;
+
+	/// @brief The object that checks the value against alarm limits, if there are any
+	std::optional<LimitMonitor> _limitMonitor;
+
+	/// @brief The conversion of the raw value into engineering units, if any
+	std::optional<ScalingTable::Scaling> _scaling;
 
 	/// @brief The state
 	/// @todo use the correct value type
 	ReadState<double> _state;
 
+	/// @brief The state of the initial read
+	StartupReader::Point _initialRead;
+	/// @brief The load shedding state
+	CycleBudget::Point _loadShedding;
+
 	/// @brief The "read" task
 	ReadTask<TemplateInput> _readTask { *this };
 };
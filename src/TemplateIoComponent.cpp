@@ -2,17 +2,30 @@
 #include "TemplateIoComponent.hpp"
 
 #include "Attributes.hpp"
+#include "ExecutionTrace.hpp"
 #include "TemplateInput.hpp"
+#include "Tasks.hpp"
 #include "TemplateOutput.hpp"
 
 #include <xentara/config/Errors.hpp>
 #include <xentara/data/ReadHandle.hpp>
+#include <xentara/data/WriteHandle.hpp>
 #include <xentara/model/Attribute.hpp>
 #include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/model/ForEachTaskFunction.hpp>
+#include <xentara/process/ExecutionContext.hpp>
 #include <xentara/skill/ElementFactory.hpp>
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
+#include <xentara/utils/eh/currentErrorCode.hpp>
 
+#include <array>
+#include <bit>
+#include <chrono>
+#include <exception>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -22,6 +35,10 @@ using namespace std::literals;
 
 auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
+	// The layout of the register image is only set at the end, once we know the byte order
+	std::size_t registerCount { 0 };
+	std::optional<RegisterImage::ByteOrder> registerByteOrder;
+
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
@@ -40,6 +57,247 @@ auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config:
 
 			/// @todo set the appropriate member variables
 		}
+		else if (name == "changeJournalSize"sv)
+		{
+			auto size = value.asNumber<std::size_t>();
+
+			// Check that the size is valid
+			if (size == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("change journal size of template I/O component must be greater than zero"));
+			}
+
+			// Create the journal
+			_changeJournal.emplace(size);
+		}
+		else if (name == "snapshotFile"sv)
+		{
+			_snapshotPath = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (_snapshotPath.empty())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("empty snapshot file name for template I/O component"));
+			}
+		}
+		else if (name == "sharedMemory"sv)
+		{
+			_sharedMemoryName = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (!_sharedMemoryName.starts_with('/') || _sharedMemoryName.find('/', 1) != std::string::npos)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("shared memory name of template I/O component must start with a slash, and contain no other slashes"));
+			}
+			if (!SharedMemoryRing::kSupported)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("shared memory is not supported for template I/O component on this system"));
+			}
+		}
+		else if (name == "sharedMemorySize"sv)
+		{
+			_sharedMemorySize = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (!std::has_single_bit(_sharedMemorySize))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("shared memory size of template I/O component must be a power of two"));
+			}
+		}
+		else if (name == "server"sv)
+		{
+			_serverAddress = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (!PipelinedClient::isValidAddress(_serverAddress))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("server address of template I/O component must have the form \"unix:<path>\" or \"tcp:<host>:<port>\""));
+			}
+			if (!PipelinedClient::kSupported)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("server connections are not supported for template I/O component on this system"));
+			}
+		}
+		else if (name == "requestWindow"sv)
+		{
+			_requestWindow = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (_requestWindow == 0 || _requestWindow > 65536)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("request window of template I/O component must be between 1 and 65536"));
+			}
+		}
+		else if (name == "requestTimeout"sv)
+		{
+			const auto timeout = value.asNumber<std::uint64_t>();
+
+			// Check that the value is valid
+			if (timeout == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("request timeout of zero for template I/O component"));
+			}
+
+			_requestTimeout = std::chrono::milliseconds(timeout);
+		}
+		else if (name == "reconnectDelay"sv)
+		{
+			const auto delay = value.asNumber<std::uint64_t>();
+
+			// Check that the value is valid
+			if (delay == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("reconnect delay of zero for template I/O component"));
+			}
+
+			_reconnectDelay = std::chrono::milliseconds(delay);
+		}
+		else if (name == "maxReconnectDelay"sv)
+		{
+			const auto delay = value.asNumber<std::uint64_t>();
+
+			// Check that the value is valid
+			if (delay == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("maximum reconnect delay of zero for template I/O component"));
+			}
+
+			_maxReconnectDelay = std::chrono::milliseconds(delay);
+		}
+		else if (name == "secondaryServer"sv)
+		{
+			auto address = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (!PipelinedClient::isValidAddress(address))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("secondary server address of template I/O component must have the form \"unix:<path>\" or \"tcp:<host>:<port>\""));
+			}
+
+			_hedgedReader.setSecondaryAddress(std::move(address));
+		}
+		else if (name == "hedgePercentile"sv)
+		{
+			const auto percentile = value.asNumber<double>();
+
+			// Check that the value is valid
+			if (!(percentile > 0.0 && percentile < 1.0))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("hedge percentile of template I/O component must be greater than 0 and less than 1"));
+			}
+
+			_hedgedReader.setHedgePercentile(percentile);
+		}
+		else if (name == "registerCount"sv)
+		{
+			registerCount = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (registerCount == 0 || registerCount > RegisterImage::kMaxRegisters)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("register count of template I/O component must be between 1 and 65536"));
+			}
+		}
+		else if (name == "registerByteOrder"sv)
+		{
+			registerByteOrder = RegisterImage::parseByteOrder(value.asString<std::string>());
+
+			// Check that the value is valid
+			if (!registerByteOrder)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown register byte order for template I/O component, must be \"big\" or \"little\""));
+			}
+		}
+		else if (name == "startupThreads"sv)
+		{
+			_startupReader.setThreadCount(value.asNumber<std::size_t>());
+		}
+		else if (name == "startupDeadline"sv)
+		{
+			const auto deadline = value.asNumber<std::uint64_t>();
+
+			// Check that the value is valid
+			if (deadline == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("startup deadline of zero for template I/O component"));
+			}
+
+			_startupReader.setDeadline(std::chrono::milliseconds(deadline));
+		}
+		else if (name == "cycleBudget"sv)
+		{
+			const auto budget = value.asNumber<std::uint64_t>();
+
+			// Check that the value is valid
+			if (budget == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("cycle budget of zero for template I/O component"));
+			}
+
+			_cycleBudget.setBudget(std::chrono::microseconds(budget));
+		}
+		else if (name == "recordFile"sv)
+		{
+			_recordPath = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (_recordPath.empty())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("empty recording file name for template I/O component"));
+			}
+		}
+		else if (name == "replayFile"sv)
+		{
+			_replayPath = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (_replayPath.empty())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("empty replay file name for template I/O component"));
+			}
+		}
+		else if (name == "traceFile"sv)
+		{
+			_tracePath = value.asString<std::string>();
+
+			// Check that the value is valid
+			if (_tracePath.empty())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("empty trace file name for template I/O component"));
+			}
+		}
+		else if (name == "traceBufferSize"sv)
+		{
+			_traceBufferSize = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (_traceBufferSize < 2)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("trace buffer size of template I/O component must be at least 2"));
+			}
+		}
+		else if (name == "traceOnOverrun"sv)
+		{
+			_traceOnOverrun = value.asBool();
+		}
+		else if (name == "compactStates"sv)
+		{
+			// Create the encoding, which also sets the epoch of the time stamps
+			if (value.asBool())
+			{
+				_compactEncoding.emplace();
+			}
+		}
+		else if (name == "replaySpeed"sv)
+		{
+			_replaySpeed = value.asNumber<double>();
+
+			// Check that the value is valid
+			if (_replaySpeed < 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("negative replay speed for template I/O component"));
+			}
+		}
 		else
 		{
             config::throwUnknownParameterError(name);
@@ -52,6 +310,34 @@ auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config:
 		/// @todo use an error message that tells the user exactly what is wrong
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("TODO is wrong with template I/O component"));
 	}
+
+	// We can't record and replay at the same time
+	if (!_recordPath.empty() && !_replayPath.empty())
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template I/O component cannot record and replay at the same time"));
+	}
+
+	// The reconnect delay can't grow beyond its maximum
+	if (_maxReconnectDelay < _reconnectDelay)
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("maximum reconnect delay of template I/O component is less than the initial delay"));
+	}
+
+	// A secondary server is only used together with a primary one
+	if (_hedgedReader.enabled() && _serverAddress.empty())
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template I/O component has a secondary server, but no server"));
+	}
+
+	// Set up the register image, if requested
+	if (registerCount != 0)
+	{
+		_registerImage.setLayout(registerCount, registerByteOrder.value_or(RegisterImage::ByteOrder::BigEndian));
+	}
+	else if (registerByteOrder)
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("template I/O component has a register byte order, but no registers"));
+	}
 }
 
 auto TemplateIoComponent::createChildElement(const skill::Element::Class &elementClass, skill::ElementFactory &factory)
@@ -71,29 +357,522 @@ auto TemplateIoComponent::createChildElement(const skill::Element::Class &elemen
 	return nullptr;
 }
 
+auto TemplateIoComponent::registerPoint(ReadState<double> &state, std::string_view primaryKey, StartupReader::Point &initialRead)
+	-> std::size_t
+{
+	const auto pointIndex = _points.size();
+	_points.push_back(state);
+	_pointKeys.push_back(ValueSnapshot::makeKey(primaryKey));
+	_initialReads.push_back(initialRead);
+	_scaling.resize(_points.size());
+	state.setPointIndex(pointIndex);
+
+	// Attach the change journal, if any
+	if (_changeJournal)
+	{
+		state.attachJournal(*_changeJournal);
+	}
+
+	// Store the state in compact form, if requested
+	if (_compactEncoding)
+	{
+		state.enableCompactStorage(*_compactEncoding);
+	}
+
+	// Check the update timeout, if the data point has one
+	_timeoutWheel.add(state);
+
+	// With the shared memory transport, the state can be updated by the "read" task of any data point, with pipelined
+	// requests, it is updated by the receiver thread of the client, and with startup threads, the initial read updates
+	// it from a worker thread while the tasks of the data point may already be running
+	if (!_sharedMemoryName.empty() || !_serverAddress.empty() || _startupReader.threaded())
+	{
+		state.enableConcurrentUpdates();
+	}
+
+	return pointIndex;
+}
+
+auto TemplateIoComponent::pointGroup(const std::string &name) -> ReadState<double>::Group &
+{
+	auto &group = _pointGroups[name];
+	if (!group)
+	{
+		group = std::make_unique<ReadState<double>::Group>();
+	}
+
+	return *group;
+}
+
+auto TemplateIoComponent::invalidatePoints(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Only the first data point to get here invalidates the data points
+	if (_pointsInvalidated.exchange(true, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	// Wait for the reads still in progress on the tasks of other data points, and then stop the threads that update
+	// data points in the background, so that no late value can overwrite the "No Data" state
+	_acquisitionGate.close();
+	stopAcquisition();
+
+	// Set each group to "No Data" in a single commit. The other data points each have their own data block, so each
+	// of them needs a commit of its own.
+	for (auto &&[name, group] : _pointGroups)
+	{
+		group->update(timeStamp, CustomError::NoData);
+	}
+	for (auto &&point : _points)
+	{
+		if (!point.get().group())
+		{
+			point.get().invalidate(timeStamp);
+		}
+	}
+}
+
 auto TemplateIoComponent::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
 {
-	/// @todo call the function with any attributes this class supports
+	return
+		// Handle the startup attributes
+		_startupReader.forEachAttribute(function) ||
+
+		// Handle the statistics of the hedged reads
+		_hedgedReader.forEachAttribute(function) ||
+
+		// Handle the timing attributes of the "read" task, if there is a register image to read
+		(_registerImage.enabled() && _readTask.timing().forEachAttribute(function)) ||
+
+		// Handle the trace dump attribute, if tracing is enabled
+		(!_tracePath.empty() && function(attributes::kDumpTrace));
 
-	return false;
+	/// @todo call the function with any additional attributes this class supports
+}
+
+auto TemplateIoComponent::forEachTask(const model::ForEachTaskFunction &function) -> bool
+{
+	// Handle all the tasks we support
+	return
+		function(tasks::kCheckpoint, sharedFromThis(&_checkpointTask)) ||
+		function(tasks::kMonitor, sharedFromThis(&_monitorTask)) ||
+		(_registerImage.enabled() && function(tasks::kRead, sharedFromThis(&_readTask)));
+
+	/// @todo handle any additional tasks this class supports
 }
 
 auto TemplateIoComponent::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
 {
-	/// @todo create read handles for any readable attributes this class supports
+	// Handle the startup attributes
+	if (auto handle = _startupReader.makeReadHandle(attribute))
+	{
+		return handle;
+	}
+
+	// Handle the statistics of the hedged reads
+	if (auto handle = _hedgedReader.makeReadHandle(attribute))
+	{
+		return handle;
+	}
+
+	// Handle the timing attributes of the "read" task
+	if (_registerImage.enabled())
+	{
+		if (auto handle = _readTask.timing().makeReadHandle(attribute))
+		{
+			return handle;
+		}
+	}
+
+	/// @todo create read handles for any additional readable attributes this class supports
+
+	// Nothing found
+	return std::nullopt;
+}
+
+auto TemplateIoComponent::makeWriteHandle(const model::Attribute &attribute) noexcept -> std::optional<data::WriteHandle>
+{
+	// Handle the trace dump attribute
+	if (attribute == attributes::kDumpTrace)
+	{
+		return data::WriteHandle { std::in_place_type<bool>, &TemplateIoComponent::requestTraceDump, weakFromThis() };
+	}
+
+	/// @todo create write handles for any additional writable attributes this class supports
 
 	// Nothing found
 	return std::nullopt;
 }
 
+auto TemplateIoComponent::realize() -> void
+{
+	// Realize the startup reader and the hedged reader
+	_startupReader.realize();
+	_hedgedReader.realize();
+	// Realize the groups of data points, whose members are all known by now
+	for (auto &&[name, group] : _pointGroups)
+	{
+		group->realize();
+	}
+	// Realize the timing information of the "read" task
+	_readTask.timing().realize();
+}
+
+auto TemplateIoComponent::requestRead(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Hedge the read over both servers, if we have two
+	if (_hedgedReader.enabled())
+	{
+		_hedgedReader.read(pointIndex, timeStamp);
+		return;
+	}
+
+	if (const auto transactionId = _client->read(pointIndex, timeStamp); !transactionId)
+	{
+		completeRead(pointIndex, timeStamp, utils::eh::unexpected(transactionId.error()));
+	}
+}
+
+auto TemplateIoComponent::addPipelinedPoint(std::size_t pointIndex) -> void
+{
+	_pipelinedPoints.push_back(pointIndex);
+}
+
+auto TemplateIoComponent::completeRead(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<double, std::error_code> &valueOrError) -> void
+{
+	auto &point = _points[pointIndex].get();
+
+	// Reads that failed because we are not connected don't commit anything, because the data point was already marked
+	// when the connection was lost
+	if (!valueOrError && valueOrError.error() == CustomError::NotConnected)
+	{
+		point.markDisconnected(timeStamp);
+	}
+	// Convert the value into engineering units
+	else if (valueOrError && _scaling.enabled())
+	{
+		point.update(timeStamp, _scaling.scale(pointIndex, *valueOrError));
+	}
+	else
+	{
+		point.update(timeStamp, valueOrError);
+	}
+
+	// Finish the initial read of the data point, if this was it
+	_startupReader.finish(_initialReads[pointIndex], valueOrError.has_value());
+}
+
+auto TemplateIoComponent::connectionChanged(std::error_code error) -> void
+{
+	// Nothing to do when the connection is established. The data points are updated by their next reads.
+	if (!error)
+	{
+		return;
+	}
+
+	/// @todo log the error
+
+	// Mark all the data points read from the server as not connected in a single pass, with a common time stamp. The
+	// others are not read through the connection, and are left alone.
+	const auto timeStamp = std::chrono::system_clock::now();
+	for (auto pointIndex : _pipelinedPoints)
+	{
+		_points[pointIndex].get().markDisconnected(timeStamp);
+	}
+}
+
+auto TemplateIoComponent::requestTraceDump(bool dump) noexcept -> void
+{
+	if (dump)
+	{
+		ExecutionTrace::requestDump();
+	}
+}
+
 auto TemplateIoComponent::prepare() -> void
 {
-	/// @todo open the handle for the I/O device
+	// Start tracing, if requested. This is done first, so the trace covers the startup as well.
+	if (!_tracePath.empty())
+	{
+		ExecutionTrace::enable(_tracePath, _traceBufferSize, _traceOnOverrun);
+	}
+
+	// If we are replaying a recording, we don't access the I/O device at all
+	if (!_replayPath.empty())
+	{
+		_replayer = std::make_unique<IoReplayer>(_replayPath, _points.size(), _replaySpeed);
+		_replayer->start();
+	}
+	else
+	{
+		/// @todo open the handle for the I/O device
+
+		// Open the shared memory transport, if requested
+		if (!_sharedMemoryName.empty())
+		{
+			_sharedMemoryTransport = std::make_unique<SharedMemoryTransport>(_sharedMemoryName, _sharedMemorySize, _points, _scaling);
+		}
+
+		// Connect to the server for pipelined requests, if requested. The connection is made in the background, so that an
+		// unreachable server does not hold up the start, and the responses are committed directly to the data points.
+		const ReconnectBackoff backoff { _reconnectDelay, _maxReconnectDelay };
+		if (_hedgedReader.enabled())
+		{
+			_hedgedReader.start(_serverAddress, _requestWindow, _requestTimeout, backoff,
+				[this](std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp,
+					const utils::eh::expected<double, std::error_code> &valueOrError) {
+					completeRead(pointIndex, timeStamp, valueOrError);
+				},
+				[this](std::error_code error) { connectionChanged(error); });
+		}
+		else if (!_serverAddress.empty())
+		{
+			_client = std::make_unique<PipelinedClient>(_serverAddress, _requestWindow, _requestTimeout, backoff,
+				[this](std::uint32_t, std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp,
+					const utils::eh::expected<double, std::error_code> &valueOrError) {
+					completeRead(pointIndex, timeStamp, valueOrError);
+				},
+				[this](std::error_code error) { connectionChanged(error); });
+			_client->start();
+		}
+
+		// Start recording, if requested
+		if (!_recordPath.empty())
+		{
+			_recorder = std::make_unique<IoRecorder>(_recordPath);
+		}
+	}
+
+	// Index the fields of the register image. All the data points have been realized by now.
+	_registerImage.prepare();
+
+	// Seed the data points with the values from the last run
+	restoreSnapshot();
+
+	// Start the update timeouts
+	_timeoutWheel.start(std::chrono::system_clock::now());
+
+	// Start waiting for notifications from data points in push mode
+	_reactor.start();
+
+	// Start the threads for the initial reads
+	_startupReader.start();
+}
+
+auto TemplateIoComponent::performCheckpointTask(const process::ExecutionContext &context) -> void
+{
+	// Do nothing if no snapshot file was configured
+	if (_snapshotPath.empty())
+	{
+		return;
+	}
+
+	// Collect the current values. Data points without a valid value keep the last value recorded in the snapshot.
+	for (std::size_t pointIndex = 0; pointIndex < _points.size(); ++pointIndex)
+	{
+		if (auto value = _points[pointIndex].get().currentValue())
+		{
+			_snapshot.set(pointIndex, value->first, value->second);
+		}
+	}
+
+	// Write the snapshot in one sequential stream
+	try
+	{
+		_snapshot.save(_snapshotPath);
+	}
+	catch (const std::exception &)
+	{
+		/// @todo log the error. We just try again on the next checkpoint.
+	}
+}
+
+auto TemplateIoComponent::performMonitorTask(const process::ExecutionContext &context) -> void
+{
+	// Leave the quality alone once the data points have been invalidated
+	const AcquisitionGate::Pass pass(_acquisitionGate);
+	if (!pass)
+	{
+		return;
+	}
+
+	// Downgrade all data points that have timed out. This only looks at data points whose timeout is due.
+	_timeoutWheel.advance(std::chrono::system_clock::now());
+}
+
+auto TemplateIoComponent::performReadTask(const process::ExecutionContext &context) -> void
+{
+	// Don't read anything once the data points have been invalidated
+	const AcquisitionGate::Pass pass(_acquisitionGate);
+	if (!pass)
+	{
+		return;
+	}
+
+	readRegisters(context.scheduledTime());
+}
+
+auto TemplateIoComponent::prepareInitialRead(const process::ExecutionContext &context) -> bool
+{
+	// Don't read anything if the data points have already been invalidated
+	const AcquisitionGate::Pass pass(_acquisitionGate);
+	if (!pass)
+	{
+		return true;
+	}
+
+	readRegisters(std::chrono::system_clock::now());
+	return true;
+}
+
+auto TemplateIoComponent::readRegisters(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// When replaying, the data points mapped to registers are not read at all, because the recording contains the
+	// values of individual data points rather than register images
+	if (_replayer)
+	{
+		return;
+	}
+
+	std::error_code error;
+
+	/// @todo read the registers from the I/O component into _registerImage.raw(), in the byte order of the device, and
+	// set error if the read failed
+
+	/// @todo if the read function throws exceptions, catch them here and use utils::eh::currentErrorCode() to get the
+	// error. Note that exceptions allocate memory, so this will abort the driver if it was built to verify that this
+	// cyclic path does not allocate memory.
+
+	// Commit errors to all the data points mapped to registers, and make sure that all of them are updated once the
+	// registers can be read again
+	if (error)
+	{
+		_registerImage.forEachPoint([&](std::size_t pointIndex) {
+			_points[pointIndex].get().update(timeStamp, utils::eh::unexpected(error));
+		});
+		_registerImage.invalidate();
+		return;
+	}
+
+	// Update the data points whose bits changed. The others keep their value and update time stamp.
+	_registerImage.decode([&](std::size_t pointIndex, unsigned value) {
+		/// @todo use the correct value type
+		const auto rawValue = double(value);
+		_points[pointIndex].get().update(timeStamp, _scaling.enabled() ? _scaling.scale(pointIndex, rawValue) : rawValue);
+	});
+}
+
+auto TemplateIoComponent::readGroup(ReadState<double>::Group &group, std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// When replaying, groups are not read at all, because the recording contains the transactions of individual
+	// data points
+	if (_replayer)
+	{
+		return;
+	}
+
+	/// @todo use the correct value type
+	std::array<double, ReadState<double>::Group::kMaxSize> values {};
+	const auto groupValues = std::span(values).first(group.size());
+
+	std::error_code error;
+
+	/// @todo read the values of all the data points of the group from the I/O component in a single transaction, in the
+	// order the data points were added to the group, and set error if the read failed
+
+	/// @todo if the read function throws exceptions, catch them here and use utils::eh::currentErrorCode() to get the
+	// error. Note that exceptions allocate memory, so this will abort the driver if it was built to verify that this
+	// cyclic path does not allocate memory.
+
+	// Commit errors to all the data points at once
+	if (error)
+	{
+		group.update(timeStamp, error);
+		return;
+	}
+
+	// Convert the values into engineering units
+	if (_scaling.enabled())
+	{
+		for (std::size_t index = 0; index < groupValues.size(); ++index)
+		{
+			groupValues[index] = _scaling.scale(group.pointIndex(index), groupValues[index]);
+		}
+	}
+
+	// Commit all the values at once
+	group.update(timeStamp, groupValues);
+}
+
+auto TemplateIoComponent::invalidateData(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	invalidatePoints(timeStamp);
+}
+
+auto TemplateIoComponent::stopAcquisition() -> void
+{
+	// Stop any initial reads still in progress, and any reads in push mode
+	_startupReader.stop();
+	_reactor.stop();
+
+	// Stop receiving responses from the servers. The connections are closed in cleanup().
+	if (_client)
+	{
+		_client->stop();
+	}
+	if (_hedgedReader.enabled())
+	{
+		_hedgedReader.stop();
+	}
+}
+
+auto TemplateIoComponent::restoreSnapshot() -> void
+{
+	// Size the snapshot for all data points, so that no allocations are necessary later
+	_snapshot.reset(_pointKeys);
+
+	// Load the snapshot, if there is one
+	if (_snapshotPath.empty() || !_snapshot.load(_snapshotPath))
+	{
+		return;
+	}
+
+	// Restore the values
+	for (std::size_t pointIndex = 0; pointIndex < _points.size(); ++pointIndex)
+	{
+		if (auto value = _snapshot.get(pointIndex))
+		{
+			_points[pointIndex].get().restore(value->first, value->second);
+		}
+	}
 }
 
 auto TemplateIoComponent::cleanup() -> void
 {
+	// Stop everything that still updates data points before closing the device. This was normally already done when
+	// the data points were invalidated.
+	stopAcquisition();
+
 	/// @todo close the handle to the I/O device
+
+	// Close the shared memory transport and the connections to the servers
+	_sharedMemoryTransport.reset();
+	_client.reset();
+
+	// Stop recording or replaying
+	if (_recorder)
+	{
+		_recorder->flush();
+	}
+	_recorder.reset();
+	_replayer.reset();
+
+	// Stop tracing, which writes a final dump
+	if (!_tracePath.empty())
+	{
+		ExecutionTrace::disable();
+	}
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
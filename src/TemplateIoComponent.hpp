@@ -1,16 +1,46 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "AcquisitionGate.hpp"
 #include "Attributes.hpp"
+#include "ChangeJournal.hpp"
+#include "CheckpointTask.hpp"
+#include "CompactEncoding.hpp"
 #include "CustomError.hpp"
+#include "CycleBudget.hpp"
+#include "HedgedReader.hpp"
+#include "IoRecorder.hpp"
+#include "IoReplayer.hpp"
+#include "MonitorTask.hpp"
+#include "PipelinedClient.hpp"
+#include "Reactor.hpp"
+#include "ReadState.hpp"
+#include "ReadTask.hpp"
+#include "RegisterImage.hpp"
+#include "ScalingTable.hpp"
+#include "SharedMemoryTransport.hpp"
+#include "StartupReader.hpp"
+#include "TimeoutWheel.hpp"
+#include "ValueSnapshot.hpp"
 
 #include <xentara/model/ElementCategory.hpp>
 #include <xentara/skill/Element.hpp>
+#include <xentara/skill/EnableSharedFromThis.hpp>
 #include <xentara/utils/tools/Unique.hpp>
 #include <xentara/utils/core/Uuid.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <string_view>
 #include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace xentara::plugins::templateDriver
 {
@@ -19,7 +49,7 @@ using namespace std::literals;
 
 /// @brief A class representing a specific type of I/O component.
 /// @todo rename this class to something more descriptive
-class TemplateIoComponent final : public skill::Element
+class TemplateIoComponent final : public skill::Element, public skill::EnableSharedFromThis<TemplateIoComponent>
 {
 public:
 	/// @brief The class object containing meta-information about this element type
@@ -42,6 +72,127 @@ public:
 		return _handle;
 	}
 
+	/// @brief Registers the read state of a data point with the I/O component
+	///
+	/// This function must be called by all data points during the realize stage.
+	/// @param state The read state of the data point
+	/// @param primaryKey The primary key of the data point, which identifies its value in the snapshot
+	/// @param initialRead The initial read state of the data point, which is finished when the response to a pipelined
+	/// initial read arrives
+	/// @return The index of the data point within the I/O component
+	/// @todo use the correct value type
+	auto registerPoint(ReadState<double> &state, std::string_view primaryKey, StartupReader::Point &initialRead) -> std::size_t;
+
+	/// @brief Returns the gate that reads must pass before they update data points
+	auto acquisitionGate() noexcept -> AcquisitionGate &
+	{
+		return _acquisitionGate;
+	}
+
+	/// @brief Sets all data points of the I/O component to "No Data"
+	///
+	/// This function is called by the I/O component and all its data points at the end of the post-operational stage.
+	/// The first call stops the threads that update data points in the background, waits for reads still in progress
+	/// on other tasks, and then invalidates all data points in a single pass with its own time stamp. Later calls do
+	/// nothing.
+	/// @param timeStamp The time stamp to use for the invalidation
+	auto invalidatePoints(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Returns the recorder that all I/O transactions should be recorded to, or nullptr if recording is not enabled
+	auto recorder() noexcept -> IoRecorder *
+	{
+		return _recorder.get();
+	}
+
+	/// @brief Returns the replayer that should be used in place of the I/O component, or nullptr if not replaying
+	auto replayer() noexcept -> IoReplayer *
+	{
+		return _replayer.get();
+	}
+
+	/// @brief Returns the shared memory transport to exchange values with a producer process, or nullptr if it is not used
+	auto sharedMemoryTransport() noexcept -> SharedMemoryTransport *
+	{
+		return _sharedMemoryTransport.get();
+	}
+
+	/// @brief Returns whether reads are sent as pipelined requests to a server
+	auto pipelined() const noexcept -> bool
+	{
+		return !_serverAddress.empty();
+	}
+
+	/// @brief Returns whether the results of reads of individual data points arrive after the read returns
+	///
+	/// This is the case for pipelined requests, unless the values are replayed or taken from the shared memory transport.
+	auto readsDeferred() const noexcept -> bool
+	{
+		return pipelined() && !_replayer && !_sharedMemoryTransport;
+	}
+
+	/// @brief Sends a pipelined read request to the server, or to both redundant servers
+	///
+	/// The data point is updated when the response arrives, or right away if the request could not be sent. While the
+	/// I/O component is not connected, the request fails right away without touching the network.
+	/// @param pointIndex The index of the data point to read
+	/// @param timeStamp The time stamp to use for the update
+	auto requestRead(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Marks a data point as read using pipelined requests
+	///
+	/// Only these data points are marked as not connected when the connection to the server is lost. This function must
+	/// be called during the realize stage.
+	/// @param pointIndex The index of the data point
+	auto addPipelinedPoint(std::size_t pointIndex) -> void;
+
+	/// @brief Returns the group with the given name, creating it if necessary
+	///
+	/// This function may only be called while loading the configuration.
+	/// @todo use the correct value type
+	auto pointGroup(const std::string &name) -> ReadState<double>::Group &;
+
+	/// @brief Reads the values of all the data points of a group in a single transaction, and commits them together
+	/// @param group The group
+	/// @param timeStamp The time stamp to use for the update
+	auto readGroup(ReadState<double>::Group &group, std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Returns the image of the registers that data points can be mapped to
+	auto registerImage() noexcept -> RegisterImage &
+	{
+		return _registerImage;
+	}
+
+	/// @brief Returns the table that converts the raw values of the data points into engineering units
+	auto scaling() noexcept -> ScalingTable &
+	{
+		return _scaling;
+	}
+
+	/// @brief Returns the cycle budget used to shed the load of the reads
+	auto cycleBudget() noexcept -> CycleBudget &
+	{
+		return _cycleBudget;
+	}
+
+	/// @brief Returns the reactor that waits for notifications from data points in push mode
+	auto reactor() noexcept -> Reactor &
+	{
+		return _reactor;
+	}
+
+	/// @brief Returns the object that performs the initial reads of the data points
+	auto startupReader() noexcept -> StartupReader &
+	{
+		return _startupReader;
+	}
+
+	/// @brief Returns the change journal, or nullptr if the journal was not enabled in the configuration
+	/// @todo use the correct value type
+	auto changeJournal() noexcept -> ChangeJournal<double> *
+	{
+		return _changeJournal ? &*_changeJournal : nullptr;
+	}
+
 	/// @name Virtual Overrides for skill::Element
 	/// @{
 
@@ -50,8 +201,12 @@ public:
 
 	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool final;
 
+	auto forEachTask(const model::ForEachTaskFunction &function) -> bool final;
+
 	auto makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle> final;
 
+	auto makeWriteHandle(const model::Attribute &attribute) noexcept -> std::optional<data::WriteHandle> final;
+
 	auto category() const noexcept -> model::ElementCategory final
 	{
 		return model::ElementCategory::Device;
@@ -60,11 +215,65 @@ public:
 	/// @}
 
 private:
+	/// @brief The checkpoint task needs access to out private member functions
+	friend class CheckpointTask<TemplateIoComponent>;
+	/// @brief The monitor task needs access to our private member functions
+	friend class MonitorTask<TemplateIoComponent>;
+	/// @brief The read task needs access to our private member functions
+	friend class ReadTask<TemplateIoComponent>;
+
+	/// @brief This function is called by the "checkpoint" task.
+	///
+	/// This function saves the last valid values of all data points to the snapshot file, if one was configured.
+	auto performCheckpointTask(const process::ExecutionContext &context) -> void;
+
+	/// @brief This function is called by the "monitor" task.
+	///
+	/// This function downgrades the quality of all data points that have not been updated within their update timeout.
+	auto performMonitorTask(const process::ExecutionContext &context) -> void;
+
+	/// @brief This function is called by the "read" task.
+	///
+	/// This function reads the register image and updates the data points mapped to registers that changed.
+	auto performReadTask(const process::ExecutionContext &context) -> void;
+	/// @brief This function is called by the "read" task to perform the initial read.
+	/// @return Always true, because the register image is read synchronously
+	auto prepareInitialRead(const process::ExecutionContext &context) -> bool;
+	/// @brief Reads the register image from the I/O component and updates the data points mapped to it
+	auto readRegisters(std::chrono::system_clock::time_point timeStamp) -> void;
+	/// @brief Invalidates the data of all data points of the I/O component
+	auto invalidateData(std::chrono::system_clock::time_point timeStamp) -> void;
+	/// @brief Stops all threads that update data points in the background
+	///
+	/// This function may be called more than once.
+	auto stopAcquisition() -> void;
+
+	/// @brief Restores the values saved in the snapshot file, if one was configured
+	auto restoreSnapshot() -> void;
+
+	/// @brief Commits the result of a pipelined read to its data point
+	/// @todo use the correct value type
+	auto completeRead(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<double, std::error_code> &valueOrError) -> void;
+
+	/// @brief Called when the connection to the server is established or lost
+	///
+	/// When the connection is lost, all data points are marked as not connected at once, so that the individual reads
+	/// do not each have to commit an error while the connection is down.
+	auto connectionChanged(std::error_code error) -> void;
+
+	/// @brief Requests a dump of the execution trace.
+	/// 
+	/// This function is called by the write handle of the trace dump attribute.
+	auto requestTraceDump(bool dump) noexcept -> void;
+
 	/// @name Virtual Overrides for skill::Element
 	/// @{
 
 	auto load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void final;
 
+	auto realize() -> void final;
+
 	auto prepare() -> void final;
 
 	auto cleanup() -> void final;
@@ -73,6 +282,99 @@ private:
 
 	/// @brief A handle to the I/O component
 	Handle _handle;
+
+	/// @brief The read states of all the data points, indexed by point index
+	/// @todo use the correct value type
+	std::vector<std::reference_wrapper<ReadState<double>>> _points;
+	/// @brief The snapshot keys of all the data points, indexed by point index
+	std::vector<std::uint64_t> _pointKeys;
+	/// @brief The initial read states of all the data points, indexed by point index
+	std::vector<std::reference_wrapper<StartupReader::Point>> _initialReads;
+	/// @brief The indices of the data points that are read using pipelined requests
+	std::vector<std::size_t> _pipelinedPoints;
+	/// @brief The gate that reads must pass before they update data points
+	AcquisitionGate _acquisitionGate;
+	/// @brief Whether the data points have already been invalidated
+	std::atomic<bool> _pointsInvalidated { false };
+	/// @brief The scaling of the raw values of all data points, indexed by point index
+	ScalingTable _scaling;
+	/// @brief The image of the registers that data points can be mapped to
+	RegisterImage _registerImage;
+	/// @brief The groups of data points that are committed together, by name
+	/// @todo use the correct value type
+	std::map<std::string, std::unique_ptr<ReadState<double>::Group>, std::less<>> _pointGroups;
+
+	/// @brief The encoding of the states of the data points, if they are stored in compact form
+	std::optional<CompactEncoding> _compactEncoding;
+
+	/// @brief The change journal, if enabled
+	/// @todo use the correct value type
+	std::optional<ChangeJournal<double>> _changeJournal;
+
+	/// @brief The path of the snapshot file, or an empty path if no snapshot should be taken
+	std::filesystem::path _snapshotPath;
+	/// @brief The snapshot. This also contains the last valid values of data points that currently have no valid value.
+	ValueSnapshot _snapshot;
+
+	/// @brief The path of the file to record all I/O transactions to, or an empty path to disable recording
+	std::filesystem::path _recordPath;
+	/// @brief The path of a recording to replay instead of accessing the I/O component, or an empty path to disable replaying
+	std::filesystem::path _replayPath;
+	/// @brief The speed factor for replaying, or 0 to replay one transaction per read or write
+	double _replaySpeed { 1.0 };
+
+	/// @brief The recorder, if recording
+	std::unique_ptr<IoRecorder> _recorder;
+	/// @brief The replayer, if replaying
+	std::unique_ptr<IoReplayer> _replayer;
+
+	/// @brief The POSIX name of the shared memory transport, or an empty string if it is not used
+	std::string _sharedMemoryName;
+	/// @brief The number of records in each ring of the shared memory transport
+	std::size_t _sharedMemorySize { 4096 };
+	/// @brief The shared memory transport, if used
+	std::unique_ptr<SharedMemoryTransport> _sharedMemoryTransport;
+
+	/// @brief The address of the server to send pipelined requests to, or an empty string if it is not used
+	std::string _serverAddress;
+	/// @brief The maximum number of pipelined requests in flight
+	std::size_t _requestWindow { 8 };
+	/// @brief The time after which a pipelined request fails
+	std::chrono::nanoseconds _requestTimeout { std::chrono::seconds(1) };
+	/// @brief The delay before the first attempt to reconnect to the server
+	std::chrono::nanoseconds _reconnectDelay { std::chrono::milliseconds(100) };
+	/// @brief The longest delay between attempts to reconnect to the server
+	std::chrono::nanoseconds _maxReconnectDelay { std::chrono::seconds(30) };
+	/// @brief The client for pipelined requests, if used without a redundant server
+	std::unique_ptr<PipelinedClient> _client;
+	/// @brief The object that hedges pipelined requests over the primary and the redundant server
+	HedgedReader _hedgedReader;
+
+	/// @brief The object that performs the initial reads of the data points
+	StartupReader _startupReader;
+
+	/// @brief The cycle budget
+	CycleBudget _cycleBudget;
+
+	/// @brief The reactor for data points in push mode
+	Reactor _reactor;
+
+	/// @brief The timer wheel that checks the update timeouts of the data points
+	TimeoutWheel _timeoutWheel;
+
+	/// @brief The path of the file to dump the execution trace to, or an empty path to disable tracing
+	std::filesystem::path _tracePath;
+	/// @brief The number of trace events each thread keeps
+	std::size_t _traceBufferSize { 65536 };
+	/// @brief Whether to dump the execution trace whenever a task overruns its cycle
+	bool _traceOnOverrun { false };
+
+	/// @brief The "checkpoint" task
+	CheckpointTask<TemplateIoComponent> _checkpointTask { *this };
+	/// @brief The "monitor" task
+	MonitorTask<TemplateIoComponent> _monitorTask { *this };
+	/// @brief The "read" task, which reads the register image
+	ReadTask<TemplateIoComponent> _readTask { *this };
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -2,10 +2,14 @@
 #include "TemplateOutput.hpp"
 
 #include "Attributes.hpp"
+#include "ExecutionTrace.hpp"
 #include "Tasks.hpp"
+#include "TemplateIoComponent.hpp"
+#include "TimeoutWheel.hpp"
 
 #include <xentara/config/Errors.hpp>
 #include <xentara/data/DataType.hpp>
+#include <xentara/data/Quality.hpp>
 #include <xentara/data/ReadHandle.hpp>
 #include <xentara/data/WriteHandle.hpp>
 #include <xentara/model/Attribute.hpp>
@@ -17,6 +21,9 @@
 #include <xentara/utils/json/decoder/Errors.hpp>
 #include <xentara/utils/eh/currentErrorCode.hpp>
 
+#include <chrono>
+#include <string>
+
 namespace xentara::plugins::templateDriver
 {
 	
@@ -26,6 +33,10 @@ const model::Attribute TemplateOutput::kValueAttribute { model::Attribute::kValu
 
 auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
+	// The update timeout is only enabled at the end, once we know the quality
+	std::chrono::milliseconds updateTimeout { 0 };
+	auto timeoutQuality = data::Quality::Uncertain;
+
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
@@ -44,6 +55,52 @@ auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Cont
 
 			/// @todo set the appropriate member variables
 		}
+		else if (name == "updateTimeout"sv)
+		{
+			updateTimeout = std::chrono::milliseconds(value.asNumber<std::uint64_t>());
+
+			// Check that the value is valid
+			if (updateTimeout == std::chrono::milliseconds::zero())
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("update timeout of zero for template output"));
+			}
+		}
+		else if (name == "timeoutQuality"sv)
+		{
+			const auto quality = TimeoutWheel::parseQuality(value.asString<std::string>());
+
+			// Check that the value is valid
+			if (!quality)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown timeout quality for template output, must be \"uncertain\" or \"bad\""));
+			}
+
+			timeoutQuality = *quality;
+		}
+		else if (name == "priority"sv)
+		{
+			const auto priority = CycleBudget::parsePriority(value.asString<std::string>());
+
+			// Check that the value is valid
+			if (!priority)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown priority for template output, must be \"low\", \"normal\" or \"critical\""));
+			}
+
+			_loadShedding.setPriority(*priority);
+		}
+		else if (name == "maxAge"sv)
+		{
+			const auto maxAge = value.asNumber<std::uint64_t>();
+
+			// Check that the value is valid
+			if (maxAge == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("maximum age of zero for template output"));
+			}
+
+			_maxAge = std::chrono::milliseconds(maxAge);
+		}
 		else
 		{
             config::throwUnknownParameterError(name);
@@ -56,37 +113,144 @@ auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Cont
 		/// @todo use an error message that tells the user exactly what is wrong
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("TODO is wrong with template output"));
 	}
+
+	// Enable the update timeout, if requested
+	if (updateTimeout != std::chrono::milliseconds::zero())
+	{
+		_readState.enableUpdateTimeout(updateTimeout, timeoutQuality);
+	}
 }
 
 auto TemplateOutput::performReadTask(const process::ExecutionContext &context) -> void
 {
+	const ExecutionTrace::Scope trace { ExecutionTrace::Span::ReadTask, _pointIndex };
+
+	// Don't read anything once the data points have been invalidated
+	const AcquisitionGate::Pass pass(_ioComponent.get().acquisitionGate());
+	if (!pass)
+	{
+		return;
+	}
+
+	// Don't read anything while the initial read is still in progress
+	if (_initialRead.pending())
+	{
+		return;
+	}
+
+	// Defer the read if the I/O component is over its cycle budget
+	auto &cycleBudget = _ioComponent.get().cycleBudget();
+	if (!cycleBudget.enabled())
+	{
+		read(context.scheduledTime());
+		return;
+	}
+	if (!cycleBudget.admit(_loadShedding, context.scheduledTime()))
+	{
+		_readState.markStale(context.scheduledTime());
+		return;
+	}
+
+	// Read the data, and charge the time it took to the cycle
+	const auto readStart = std::chrono::steady_clock::now();
 	read(context.scheduledTime());
+	cycleBudget.charge(context.scheduledTime(), std::chrono::steady_clock::now() - readStart);
+}
+
+auto TemplateOutput::prepareInitialRead(const process::ExecutionContext &context) -> bool
+{
+	// Don't read anything if the data points have already been invalidated
+	const AcquisitionGate::Pass pass(_ioComponent.get().acquisitionGate());
+	if (!pass)
+	{
+		return true;
+	}
+
+	return _ioComponent.get().startupReader().prepare(_initialRead, [this]() {
+		read(std::chrono::system_clock::now());
+
+		// With pipelined requests, the initial read is finished by the I/O component when the response arrives
+		if (_ioComponent.get().readsDeferred())
+		{
+			return StartupReader::Result::Deferred;
+		}
+		return _readState.currentValue() ? StartupReader::Result::Valid : StartupReader::Result::Invalid;
+	});
 }
 
 auto TemplateOutput::read(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	try
+	auto &ioComponent = _ioComponent.get();
+
+	// If we are replaying a recording, take the result from the recording instead of the I/O component
+	if (auto replayer = ioComponent.replayer())
 	{
-		/// @todo read the value
-		double value = {};
+		if (auto valueOrError = replayer->nextRead(_pointIndex))
+		{
+			_readState.update(timeStamp, *valueOrError);
+		}
+		return;
+	}
 
-		/// @todo if the read function does not throw errors, but uses return types or internal handle state,
-		// throw an std::system_error here on failure, or call _readState.update() directly.
+	// If we are using the shared memory transport, take the values from the shared memory ring. This updates all the data
+	// points the producer sent values for, not just this one.
+	if (auto transport = ioComponent.sharedMemoryTransport())
+	{
+		transport->receive(timeStamp);
+		return;
+	}
 
-		// The read was successful
-		_readState.update(timeStamp, value);
+	// If we are using pipelined requests, just send the request. The state is updated once the response arrives.
+	if (ioComponent.pipelined())
+	{
+		ioComponent.requestRead(_pointIndex, timeStamp);
+		return;
 	}
-	catch (const std::exception &)
+
+	// Get the recorder, if we are recording
+	const auto recorder = ioComponent.recorder();
+	const auto readStart = recorder ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+	double value = {};
+	std::error_code error;
 	{
-		// Get the error from the current exception using this special utility function
-		const auto error = utils::eh::currentErrorCode();
+		const ExecutionTrace::Scope trace { ExecutionTrace::Span::DeviceRead, _pointIndex };
+
+		/// @todo read the value, and set error if the read failed
+		value = {};
+
+		/// @todo if the read function throws exceptions, catch them here and use utils::eh::currentErrorCode() to get
+		// the error. Note that exceptions allocate memory, so this will abort the driver if it was built to verify that
+		// this cyclic path does not allocate memory.
+	}
+
+	// Handle errors
+	if (error)
+	{
+		// Record the error, if requested
+		if (recorder)
+		{
+			recorder->recordRead(_pointIndex, readStart, utils::eh::unexpected(error));
+		}
 		// Update the state
 		_readState.update(timeStamp, utils::eh::unexpected(error));
+		return;
+	}
+
+	// Record the raw result, if requested
+	if (recorder)
+	{
+		recorder->recordRead(_pointIndex, readStart, value);
 	}
+
+	// The read was successful
+	_readState.update(timeStamp, value);
 }
 
 auto TemplateOutput::performWriteTask(const process::ExecutionContext &context) -> void
 {
+	const ExecutionTrace::Scope trace { ExecutionTrace::Span::WriteTask, _pointIndex };
+
 	write(context.scheduledTime());
 }
 
@@ -100,30 +264,67 @@ auto TemplateOutput::write(std::chrono::system_clock::time_point timeStamp) -> v
 		return;
 	}
 
-	try
+	auto &ioComponent = _ioComponent.get();
+
+	// If we are replaying a recording, take the result from the recording instead of the I/O component
+	if (auto replayer = ioComponent.replayer())
 	{
-		/// @todo write the value
+		_writeState.update(timeStamp, replayer->nextWrite(_pointIndex));
+		return;
+	}
 
-		/// @todo if the write function does not throw errors, but uses return types or internal handle state,
-		// throw an std::system_error here on failure, or call _writeState.update() directly.
+	// Get the recorder, if we are recording
+	const auto recorder = ioComponent.recorder();
+	const auto writeStart = std::chrono::steady_clock::now();
 
-		// The write was successful
-		_writeState.update(timeStamp, std::error_code());
-	}
-	catch (const std::exception &)
+	// Discard the value if it has been waiting for too long, e.g. because the device was unreachable
+	if (writeStart - pendingValue->_enqueueTime > _maxAge)
 	{
-		// Get the error from the current exception using this special utility function
-		const auto error = utils::eh::currentErrorCode();
+		const std::error_code error = CustomError::StaleValue;
+		// Record the error, if requested, so that it will be replayed as well
+		if (recorder)
+		{
+			recorder->recordWrite(_pointIndex, writeStart, pendingValue->_value, error);
+		}
 		// Update the state
 		_writeState.update(timeStamp, error);
+		return;
+	}
+
+	// If we are using the shared memory transport, send the value to the producer
+	if (auto transport = ioComponent.sharedMemoryTransport())
+	{
+		const auto error = transport->send(_pointIndex, pendingValue->_value);
+		_writeState.update(timeStamp, error, error ? std::nullopt : std::optional(std::chrono::steady_clock::now() - pendingValue->_enqueueTime));
+		return;
 	}
+
+	std::error_code error;
+	{
+		const ExecutionTrace::Scope trace { ExecutionTrace::Span::DeviceWrite, _pointIndex };
+
+		/// @todo write the value, and set error if the write failed
+
+		/// @todo if the write function throws exceptions, catch them here and use utils::eh::currentErrorCode() to get
+		// the error. Note that exceptions allocate memory, so this will abort the driver if it was built to verify that
+		// this cyclic path does not allocate memory.
+	}
+
+	// Record the result, if requested
+	if (recorder)
+	{
+		recorder->recordWrite(_pointIndex, writeStart, pendingValue->_value, error);
+	}
+
+	// Update the state. The latency is only measured for successful writes.
+	_writeState.update(timeStamp, error, error ? std::nullopt : std::optional(std::chrono::steady_clock::now() - pendingValue->_enqueueTime));
 }
 
 auto TemplateOutput::invalidateData(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	// Set the state to "No Data"
+	// The I/O component invalidates the read states of all its data points at once
 	// Note: the write state is not invalidated, because the write state simply contains the last write error.
-	_readState.update(timeStamp, utils::eh::unexpected(CustomError::NoData));
+	_ioComponent.get().invalidatePoints(timeStamp);
 }
 
 auto TemplateOutput::dataType() const -> const data::DataType &
@@ -145,7 +346,11 @@ auto TemplateOutput::forEachAttribute(const model::ForEachAttributeFunction &fun
 		// Handle the read state attributes
 		_readState.forEachAttribute(function) ||
 		// Handle the write state attributes
-		_writeState.forEachAttribute(function);
+		_writeState.forEachAttribute(function) ||
+
+		// Handle the task timing attributes
+		_readTask.timing().forEachAttribute(function) ||
+		_writeTask.timing().forEachAttribute(function);
 
 	/// @todo handle any additional attributes this class supports, including attributes inherited from the I/O component
 }
@@ -190,6 +395,16 @@ auto TemplateOutput::makeReadHandle(const model::Attribute &attribute) const noe
 		return handle;
 	}
 
+	// Handle the task timing attributes
+	if (auto handle = _readTask.timing().makeReadHandle(attribute))
+	{
+		return handle;
+	}
+	if (auto handle = _writeTask.timing().makeReadHandle(attribute))
+	{
+		return handle;
+	}
+
 	/// @todo handle any additional readable attributes this class supports, including attributes inherited from the I/O component
 
 	return std::nullopt;
@@ -212,9 +427,23 @@ auto TemplateOutput::makeWriteHandle(const model::Attribute &attribute) noexcept
 
 auto TemplateOutput::realize() -> void
 {
+	// Register with the I/O component. This must be done before realizing the read state, because the I/O component
+	// decides how the state is stored.
+	_pointIndex = _ioComponent.get().registerPoint(_readState, primaryKey(), _initialRead);
+	_writeState.setPointIndex(_pointIndex);
+	// Let the I/O component know if we are read using pipelined requests, so that we are marked as not connected when
+	// the connection to the server is lost
+	if (_ioComponent.get().pipelined())
+	{
+		_ioComponent.get().addPipelinedPoint(_pointIndex);
+	}
+
 	// Realize the state objects
-	_readState.realize();
+	_readState.realize(sharedFromThis());
 	_writeState.realize();
+	// Realize the task timing information
+	_readTask.timing().realize();
+	_writeTask.timing().realize();
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
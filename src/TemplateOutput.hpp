@@ -3,7 +3,9 @@
 
 #include "ReadState.hpp"
 #include "WriteState.hpp"
+#include "CycleBudget.hpp"
 #include "ReadTask.hpp"
+#include "StartupReader.hpp"
 #include "SingleValueQueue.hpp"
 #include "WriteTask.hpp"
 
@@ -11,6 +13,8 @@
 #include <xentara/skill/DataPoint.hpp>
 #include <xentara/skill/EnableSharedFromThis.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <string_view>
 
@@ -72,6 +76,9 @@ private:
 	///
 	/// This function attempts to read the value if the I/O component is up.
 	auto performReadTask(const process::ExecutionContext &context) -> void;
+	/// @brief This function is called by the "read" task to perform the initial read.
+	/// @return Whether the initial read is done, or the startup deadline has expired
+	auto prepareInitialRead(const process::ExecutionContext &context) -> bool;
 	/// @brief Attempts to read the data from the I/O component and updates the state accordingly.
 	auto read(std::chrono::system_clock::time_point timeStamp) -> void;
 
@@ -82,7 +89,7 @@ private:
 	/// @brief Attempts to write any pending value to the I/O component and updates the state accordingly.
 	auto write(std::chrono::system_clock::time_point timeStamp) -> void;	
 
-	/// @brief Invalidates any read data
+	/// @brief Invalidates any read data, along with the data of all other data points of the I/O component
 	auto invalidateData(std::chrono::system_clock::time_point timeStamp) -> void;
 
 	/// @brief Schedules a value to be written.
@@ -106,6 +113,8 @@ private:
 	/// @brief The I/O component this output belongs to
 	/// @todo give this a more descriptive name, e.g. "_device"
 	std::reference_wrapper<TemplateIoComponent> _ioComponent;
+	/// @brief The index of this data point within the I/O component
+	std::size_t _pointIndex { 0 };
 
 	/// @brief The read state
 	/// @todo use the correct value type
@@ -116,6 +125,13 @@ private:
 	/// @brief The queue for the pending output value
 	/// @todo use the correct value type
 	SingleValueQueue<double> _pendingOutputValue;
+	/// @brief The maximum time a value may spend in the queue before it is considered stale and discarded
+	std::chrono::nanoseconds _maxAge { std::chrono::nanoseconds::max() };
+
+	/// @brief The state of the initial read
+	StartupReader::Point _initialRead;
+	/// @brief The load shedding state
+	CycleBudget::Point _loadShedding;
 
 	/// @brief The "read" task
 	ReadTask<TemplateOutput> _readTask { *this };
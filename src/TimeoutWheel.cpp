@@ -0,0 +1,98 @@
+// Copyright (c) embedded ocean GmbH
+#include "TimeoutWheel.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+auto TimeoutWheel::parseQuality(std::string_view name) noexcept -> std::optional<data::Quality>
+{
+	if (name == "uncertain"sv)
+	{
+		return data::Quality::Uncertain;
+	}
+	else if (name == "bad"sv)
+	{
+		return data::Quality::Bad;
+	}
+
+	return std::nullopt;
+}
+
+auto TimeoutWheel::add(ReadState<double> &state) -> void
+{
+	// Ignore data points without a timeout
+	if (state.updateTimeout() == std::chrono::nanoseconds::zero())
+	{
+		return;
+	}
+
+	_entries.push_back({ ._state = state, ._deadline = {}, ._next = kEndOfList });
+}
+
+auto TimeoutWheel::start(std::chrono::system_clock::time_point now) -> void
+{
+	// Clear all slots
+	_slots.fill(kEndOfList);
+	_currentTick = tickOf(now);
+
+	// Arm all the timeouts
+	for (std::uint32_t index = 0; index < _entries.size(); ++index)
+	{
+		auto &entry = _entries[index];
+		entry._deadline = now + entry._state.get().updateTimeout();
+		insert(index);
+	}
+}
+
+auto TimeoutWheel::advance(std::chrono::system_clock::time_point now) -> void
+{
+	// Get the range of ticks to process. If more time than one turn of the wheel has passed, every slot is processed
+	// exactly once.
+	const auto nowTick = tickOf(now);
+	if (nowTick <= _currentTick)
+	{
+		return;
+	}
+	const auto firstTick = std::max(_currentTick + 1, nowTick - std::int64_t(kSlotCount) + 1);
+	_currentTick = nowTick;
+
+	for (auto tick = firstTick; tick <= nowTick; ++tick)
+	{
+		// Detach the list of the slot, so that entries can be reinserted into the same slot while we walk the list
+		auto &slot = _slots[std::size_t(tick) % kSlotCount];
+		auto next = std::exchange(slot, kEndOfList);
+
+		while (next != kEndOfList)
+		{
+			const auto index = next;
+			auto &entry = _entries[index];
+			next = entry._next;
+
+			// Entries for later turns of the wheel are simply put back. Expired entries are checked against the actual update
+			// time of the data point, which also tells us when to check the entry next.
+			if (entry._deadline <= now)
+			{
+				entry._deadline = entry._state.get().checkUpdateTimeout(now);
+			}
+			insert(index);
+		}
+	}
+}
+
+auto TimeoutWheel::insert(std::uint32_t index) noexcept -> void
+{
+	auto &entry = _entries[index];
+
+	// Entries due within the current tick go into the next slot, because the current slot has already been processed
+	const auto tick = std::max(tickOf(entry._deadline), _currentTick + 1);
+	auto &slot = _slots[std::size_t(tick) % kSlotCount];
+	entry._next = slot;
+	slot = index;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,99 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ReadState.hpp"
+
+#include <xentara/data/Quality.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Downgrades the quality of data points whose value has not been updated within their update timeout.
+///
+/// The wheel is a hashed timer wheel with one slot per tick of @ref kResolution. Each data point with an update
+/// timeout is kept in the slot of the time its value would expire. The wheel is evaluated lazily: updating a data
+/// point does not touch the wheel at all. Only when the slot of a data point comes up does the wheel look at the
+/// actual update time of the value, and either downgrade the data point, or move it to the slot of its new expiry
+/// time. This means that the cost of the wheel depends only on the number of timeouts that come due, and not on the
+/// number of data points or on how often they are read.
+///
+/// @note The wheel is not thread safe. All data points must be added before the wheel is started, and
+/// advance() must only ever be called from one thread at a time.
+class TimeoutWheel final
+{
+public:
+	/// @brief Parses the name of the quality that data points are downgraded to
+	/// @param name The name, either "uncertain" or "bad"
+	/// @return The quality, or std::nullopt if the name is not valid
+	static auto parseQuality(std::string_view name) noexcept -> std::optional<data::Quality>;
+
+	/// @brief Adds a data point to the wheel
+	///
+	/// This function must be called during the realize stage. Data points without an update timeout are ignored.
+	/// @param state The read state of the data point
+	/// @todo use the correct value type
+	auto add(ReadState<double> &state) -> void;
+
+	/// @brief Checks whether any data points have been added to the wheel
+	auto empty() const noexcept -> bool
+	{
+		return _entries.empty();
+	}
+
+	/// @brief Starts the timeouts of all data points
+	/// @param now The current time. All data points expire one update timeout after this time, unless they are updated.
+	auto start(std::chrono::system_clock::time_point now) -> void;
+
+	/// @brief Downgrades all data points that have expired since the last call
+	///
+	/// All data points that expire in the same call are downgraded in a single pass, with a common time stamp.
+	/// @param now The current time
+	auto advance(std::chrono::system_clock::time_point now) -> void;
+
+private:
+	/// @brief The duration of a single tick of the wheel
+	static constexpr std::chrono::milliseconds kResolution { 10 };
+	/// @brief The number of slots. The wheel turns once every 40.96 seconds, longer timeouts take several turns.
+	static constexpr std::size_t kSlotCount { 4096 };
+	/// @brief The index used to mark the end of a list
+	static constexpr std::uint32_t kEndOfList { UINT32_MAX };
+
+	/// @brief A single data point in the wheel
+	struct Entry final
+	{
+		/// @brief The read state of the data point
+		/// @todo use the correct value type
+		std::reference_wrapper<ReadState<double>> _state;
+		/// @brief The time the value expires, unless it has been updated in the meantime
+		std::chrono::system_clock::time_point _deadline;
+		/// @brief The index of the next entry in the same slot, or kEndOfList
+		std::uint32_t _next { kEndOfList };
+	};
+
+	/// @brief Returns the tick a time point falls into
+	static auto tickOf(std::chrono::system_clock::time_point timePoint) noexcept -> std::int64_t
+	{
+		return std::chrono::floor<std::chrono::milliseconds>(timePoint).time_since_epoch() / kResolution;
+	}
+
+	/// @brief Inserts an entry into the slot of its deadline
+	auto insert(std::uint32_t index) noexcept -> void;
+
+	/// @brief All the data points. The slots link these using their indices, so no memory is allocated while running.
+	std::vector<Entry> _entries;
+	/// @brief The index of the first entry of each slot, or kEndOfList for an empty slot
+	std::array<std::uint32_t, kSlotCount> _slots;
+	/// @brief The last tick that was processed
+	std::int64_t _currentTick { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
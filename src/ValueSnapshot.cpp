@@ -0,0 +1,153 @@
+// Copyright (c) embedded ocean GmbH
+#include "ValueSnapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+#if defined(__unix__)
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief The header of a snapshot file
+	struct Header final
+	{
+		/// @brief The magic number identifying the file type
+		std::array<char, 8> _magic;
+		/// @brief The file format version
+		std::uint32_t _version;
+		/// @brief The size of a record, as a sanity check
+		std::uint32_t _recordSize;
+		/// @brief The number of records
+		std::uint64_t _pointCount;
+	};
+
+	/// @brief The magic number of snapshot files
+	constexpr std::array<char, 8> kMagic { 'X', 'T', 'D', 'S', 'N', 'A', 'P', '\0' };
+
+	/// @brief The current file format version. Version 1 had no keys, and is not restored.
+	constexpr std::uint32_t kVersion = 2;
+
+} // namespace
+
+auto ValueSnapshot::makeKey(std::string_view primaryKey) noexcept -> std::uint64_t
+{
+	// Use the 64-bit FNV-1a hash, which is stable across runs and platforms
+	std::uint64_t hash = 0xcbf29ce484222325;
+	for (const auto character : primaryKey)
+	{
+		hash ^= std::uint8_t(character);
+		hash *= 0x100000001b3;
+	}
+
+	return hash;
+}
+
+auto ValueSnapshot::load(const std::filesystem::path &path) -> bool
+{
+	// Clear all the values first, in case we can't load the file
+	clearValues();
+
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		return false;
+	}
+
+	// Read and check the header. The number of records must match the size of the file, so that a damaged header
+	// cannot make us allocate huge amounts of memory.
+	Header header {};
+	std::error_code error;
+	const auto fileSize = std::filesystem::file_size(path, error);
+	if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+		header._magic != kMagic ||
+		header._version != kVersion ||
+		header._recordSize != sizeof(Record) ||
+		error ||
+		fileSize != sizeof(Header) + header._pointCount * sizeof(Record))
+	{
+		return false;
+	}
+
+	// Read all records in one go
+	std::vector<Record> saved(header._pointCount);
+	if (!stream.read(reinterpret_cast<char *>(saved.data()), std::streamsize(saved.size() * sizeof(Record))))
+	{
+		return false;
+	}
+
+	// Match the saved records to our data points by key
+	std::ranges::stable_sort(saved, {}, &Record::_key);
+	for (auto &record : _records)
+	{
+		const auto match = std::ranges::lower_bound(saved, record._key, {}, &Record::_key);
+		if (match != saved.end() && match->_key == record._key)
+		{
+			record = *match;
+		}
+	}
+
+	return true;
+}
+
+auto ValueSnapshot::save(const std::filesystem::path &path) const -> void
+{
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		// Write the header and all records sequentially
+		const Header header { kMagic, kVersion, std::uint32_t(sizeof(Record)), _records.size() };
+		stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char *>(_records.data()), std::streamsize(_records.size() * sizeof(Record)));
+		stream.flush();
+
+		if (!stream)
+		{
+			throw std::system_error(errno, std::generic_category(), "could not write value snapshot");
+		}
+	}
+
+#if defined(__unix__)
+	// Flush the file to disk before renaming it, so that a crash cannot leave an empty or partial file under the
+	// final name
+	const auto fileDescriptor = ::open(temporaryPath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fileDescriptor < 0)
+	{
+		throw std::system_error(errno, std::generic_category(), "could not open value snapshot");
+	}
+	const auto result = ::fsync(fileDescriptor);
+	const auto syncError = errno;
+	::close(fileDescriptor);
+	if (result != 0)
+	{
+		throw std::system_error(syncError, std::generic_category(), "could not flush value snapshot");
+	}
+#endif
+
+	// Replace the old file
+	std::filesystem::rename(temporaryPath, path);
+}
+
+auto ValueSnapshot::clearValues() noexcept -> void
+{
+	for (auto &record : _records)
+	{
+		record._timeStamp = 0;
+		record._value = 0;
+		record._valid = 0;
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,110 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A snapshot of the last valid values of all data points of an I/O component.
+///
+/// The snapshot is stored as a header followed by one fixed-size record per data point, in point index order. It is
+/// always written and read as a whole, using a single sequential stream, and is replaced atomically when saved. Each
+/// record carries a key derived from the primary key of its data point, and values are restored by key, so that data
+/// points that were added, removed or reordered since the snapshot was written never receive the value of another one.
+///
+/// @note The file uses the native byte order and floating point representation, and is not meant to be moved between
+/// machines of different architectures.
+class ValueSnapshot final
+{
+public:
+	/// @brief The record for a single data point
+	struct Record final
+	{
+		/// @brief The key of the data point
+		std::uint64_t _key { 0 };
+		/// @brief The update time of the value, in system clock ticks since the epoch
+		std::int64_t _timeStamp { 0 };
+		/// @brief The value
+		/// @todo use the correct value type
+		double _value { 0 };
+		/// @brief Whether the record contains a value
+		std::uint64_t _valid { 0 };
+	};
+	static_assert(std::is_trivially_copyable_v<Record>);
+
+	/// @brief Computes the key of a data point
+	/// @param primaryKey The primary key of the data point
+	static auto makeKey(std::string_view primaryKey) noexcept -> std::uint64_t;
+
+	/// @brief Resizes the snapshot for a set of data points. All values are cleared.
+	/// @param keys The keys of the data points, in point index order
+	auto reset(std::span<const std::uint64_t> keys) -> void
+	{
+		_records.assign(keys.size(), Record {});
+		for (std::size_t pointIndex = 0; pointIndex < keys.size(); ++pointIndex)
+		{
+			_records[pointIndex]._key = keys[pointIndex];
+		}
+	}
+
+	/// @brief Returns the number of data points
+	auto size() const noexcept -> std::size_t
+	{
+		return _records.size();
+	}
+
+	/// @brief Stores a value for a data point
+	auto set(std::size_t pointIndex, std::chrono::system_clock::time_point timeStamp, double value) noexcept -> void
+	{
+		auto &record = _records[pointIndex];
+		record._timeStamp = timeStamp.time_since_epoch().count();
+		record._value = value;
+		record._valid = 1;
+	}
+
+	/// @brief Gets the value of a data point, if there is one
+	auto get(std::size_t pointIndex) const noexcept -> std::optional<std::pair<std::chrono::system_clock::time_point, double>>
+	{
+		const auto &record = _records[pointIndex];
+		if (!record._valid)
+		{
+			return std::nullopt;
+		}
+		return std::pair { std::chrono::system_clock::time_point(std::chrono::system_clock::duration(record._timeStamp)), record._value };
+	}
+
+	/// @brief Loads the snapshot from a file
+	///
+	/// The values are matched to the data points by key. Data points without a record in the file are left cleared.
+	/// If the file cannot be read, all values are left cleared.
+	/// @param path The path of the file
+	/// @return Whether the file was loaded
+	auto load(const std::filesystem::path &path) -> bool;
+
+	/// @brief Saves the snapshot to a file.
+	///
+	/// The data is written to a temporary file, which is flushed to disk and then renamed, so that the file is never
+	/// left half-written, even if the system crashes.
+	/// @param path The path of the file
+	/// @throw std::system_error The file could not be written
+	auto save(const std::filesystem::path &path) const -> void;
+
+private:
+	/// @brief Clears the values of all records, keeping the keys
+	auto clearValues() noexcept -> void;
+
+	/// @brief The records
+	std::vector<Record> _records;
+};
+
+} // namespace xentara::plugins::templateDriver
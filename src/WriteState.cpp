@@ -3,10 +3,13 @@
 
 #include "Attributes.hpp"
 #include "Events.hpp"
+#include "ExecutionTrace.hpp"
+#include "NoAllocationScope.hpp"
 
 #include <xentara/memory/memoryResources.hpp>
 #include <xentara/memory/WriteSentinel.hpp>
 
+#include <algorithm>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -19,7 +22,9 @@ auto WriteState::forEachAttribute(const model::ForEachAttributeFunction &functio
 	// Handle all the attributes we support
 	return
 		function(model::Attribute::kWriteTime) ||
-		function(attributes::kWriteError);
+		function(attributes::kWriteError) ||
+		function(attributes::kWriteLatency) ||
+		function(attributes::kWriteLatencyP99);
 }
 
 auto WriteState::forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool
@@ -41,6 +46,14 @@ auto WriteState::makeReadHandle(const model::Attribute &attribute) const noexcep
 	{
 		return _dataBlock.member(&State::_writeError);
 	}
+	else if (attribute == attributes::kWriteLatency)
+	{
+		return _dataBlock.member(&State::_writeLatency);
+	}
+	else if (attribute == attributes::kWriteLatencyP99)
+	{
+		return _dataBlock.member(&State::_writeLatencyP99);
+	}
 
 	return std::nullopt;
 }
@@ -51,19 +64,38 @@ auto WriteState::realize() -> void
 	_dataBlock.create(memory::memoryResources::data());
 }
 
-auto WriteState::update(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void
+auto WriteState::update(std::chrono::system_clock::time_point timeStamp, std::error_code error,
+	std::optional<std::chrono::nanoseconds> latency) -> void
 {
+	// Updating the state must not allocate any memory, as it is done on the cyclic path
+	const NoAllocationScope noAllocation;
+
 	// Make a write sentinel
 	memory::WriteSentinel sentinel { _dataBlock };
 	auto &state = *sentinel;
+	const auto &oldState = sentinel.oldValue();
 
 	// Update the state
 	state._writeTime = timeStamp;
 	state._writeError = error;
 
+	// Update the latency. We always need to write these, even if they are unchanged, because memory resources use swap-in.
+	if (latency)
+	{
+		_writeLatencies.record(*latency);
+		state._writeLatency = std::uint64_t(std::max<std::chrono::nanoseconds::rep>(latency->count(), 0));
+		state._writeLatencyP99 = std::uint64_t(_writeLatencies.percentile(0.99).count());
+	}
+	else
+	{
+		state._writeLatency = oldState._writeLatency;
+		state._writeLatencyP99 = oldState._writeLatencyP99;
+	}
+
 	// Determine the correct event
 	const auto &event = error ? _writeErrorEvent : _writtenEvent;
 	// Commit the data and raise the event
+	const ExecutionTrace::Scope trace { ExecutionTrace::Span::Commit, _pointIndex };
 	sentinel.commit(timeStamp, event);
 }
 
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Attributes.hpp"
+#include "LatencyHistogram.hpp"
 
 #include <xentara/data/ReadHandle.hpp>
 #include <xentara/memory/ObjectBlock.hpp>
@@ -11,6 +12,8 @@
 
 #include <chrono>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <memory>
 
@@ -46,10 +49,25 @@ public:
 	/// @brief Realizes the state
 	auto realize() -> void;
 
+	/// @brief Sets the index of the data point within its I/O component, which is used in traces
+	auto setPointIndex(std::size_t pointIndex) noexcept -> void
+	{
+		_pointIndex = pointIndex;
+	}
+
 	/// @brief Updates the data and sends events
 	/// @param timeStamp The update time stamp
 	/// @param error The error code, or a default constructed std::error_code object if no error occurred
-	auto update(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void;
+	/// @param latency The time between scheduling the value and writing it to the device, or std::nullopt if the
+	/// value was not written to the device
+	auto update(std::chrono::system_clock::time_point timeStamp, std::error_code error,
+		std::optional<std::chrono::nanoseconds> latency = std::nullopt) -> void;
+
+	/// @brief Returns the distribution of the times between scheduling values and writing them to the device
+	auto writeLatencies() const noexcept -> const LatencyHistogram &
+	{
+		return _writeLatencies;
+	}
 
 private:
 	/// @brief This structure is used to represent the state inside the memory block
@@ -60,6 +78,10 @@ private:
 		/// @brief The error code when writing the value, or a default constructed std::error_code object for none.
 		/// @note The error is default initialized, because it is not an error if the value was never written.
 		std::error_code _writeError;
+		/// @brief The time between scheduling and writing the last value that was written to the device, in nanoseconds
+		std::uint64_t _writeLatency { 0 };
+		/// @brief The 99th percentile of the time between scheduling and writing values, in nanoseconds
+		std::uint64_t _writeLatencyP99 { 0 };
 	};
 
 	/// @brief A Xentara event that is raised when the value was successfully written
@@ -69,6 +91,12 @@ private:
 
 	/// @brief The data block that contains the state
 	memory::ObjectBlock<State> _dataBlock;
+
+	/// @brief The times between scheduling values and writing them to the device
+	LatencyHistogram _writeLatencies;
+
+	/// @brief The index of the data point within its I/O component
+	std::size_t _pointIndex { 0 };
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
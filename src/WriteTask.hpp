@@ -1,6 +1,10 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "Attributes.hpp"
+#include "NoAllocationScope.hpp"
+#include "TaskTiming.hpp"
+
 #include <xentara/process/Task.hpp>
 #include <xentara/process/ExecutionContext.hpp>
 
@@ -40,9 +44,32 @@ public:
 		
 	/// @}
 
+	/// @brief Returns the timing information of the task
+	auto timing() noexcept -> TaskTiming &
+	{
+		return _timing;
+	}
+
+	/// @brief Returns the timing information of the task
+	auto timing() const noexcept -> const TaskTiming &
+	{
+		return _timing;
+	}
+
 private:
+	/// @brief The attributes the timing information is published under
+	static constexpr TaskTiming::AttributeSet kTimingAttributes {
+		&attributes::kWriteStartDelayP99,
+		&attributes::kWriteStartDelayMax,
+		&attributes::kWriteExecutionTimeP99,
+		&attributes::kWriteExecutionTimeMax,
+		&attributes::kWriteOverruns };
+
 	/// @brief A reference to the target element
 	std::reference_wrapper<Target> _target;
+
+	/// @brief The timing information
+	TaskTiming _timing { kTimingAttributes };
 };
 
 template <typename Target>
@@ -65,7 +92,11 @@ auto WriteTask<Target>::preOperational(const process::ExecutionContext &context)
 template <typename Target>
 auto WriteTask<Target>::operational(const process::ExecutionContext &context) -> void
 {
-	_target.get().performWriteTask(context);
+	// The cyclic path must not allocate any memory
+	const NoAllocationScope noAllocation;
+
+	// Measure the timing of the task
+	_timing.measure(context, [&]() { _target.get().performWriteTask(context); });
 }
 
 template <typename Target>